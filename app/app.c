@@ -16,6 +16,9 @@
 #include "task_handler.h"
 #include "softstrap.h"
 #include "vpd_section.h"
+#include "ec_settings.h"
+#include "flashhdr.h"
+#include "espioob_mngr.h"
 
 LOG_MODULE_REGISTER(ecfw, CONFIG_EC_LOG_LEVEL);
 
@@ -50,16 +53,34 @@ void main(void)
 		return;
 	}
 
-    /*
-     * setup EMI in order to extract, store
-     * and share VPDs with the host CPU.
-     * */
-    expose_vpd_section();
+	/* Load persistent settings before any task uses them */
+	ret = ec_settings_init();
+	if (ret) {
+		LOG_WRN("Persistent settings unavailable %d", ret);
+	}
 
 	strap_init();
 	start_all_tasks();
 
+	/* Setup EMI in order to extract, store and share VPDs with the host
+	 * CPU. Host waits for the VPD block generation, tasks do not wait for
+	 * the EEPROM read.
+	 */
+	expose_vpd_section();
+
+	/* Runs in background, tasks are not delayed */
+	ecfw_image_verify_start();
+
+	/* Tasks only run on their own wake sources, main has nothing left
+	 * to do besides optional wakeup and latency accounting.
+	 */
 	while (true) {
-		k_msleep(2100);
+#if CONFIG_EC_TASK_STATS_REPORT_SEC
+		k_sleep(K_SECONDS(CONFIG_EC_TASK_STATS_REPORT_SEC));
+		ec_task_report();
+		oob_report_stats();
+#else
+		k_sleep(K_FOREVER);
+#endif
 	}
 }
@@ -10,9 +10,22 @@
 #include "espi_hub.h"
 #include "postcodemgmt.h"
 #include "port80display.h"
+#include "task_handler.h"
+#ifdef CONFIG_BINLOG
+#include "binlog.h"
+#endif
 LOG_MODULE_REGISTER(postcode, CONFIG_POSTCODE_LOG_LEVEL);
 
-static struct k_sem update_lock;
+#define POSTCODE_EVT_UPDATE	BIT(0)
+
+static EC_TASK_DEFINE(postcode_task, "POST", 0, 0, EC_TASK_PSTATE_ANY);
+
+/* Display refresh rate limit, postcodes received meanwhile are deferred to
+ * its expiry instead of the task sleeping.
+ */
+static void postcode_holdoff_expired(struct k_timer *timer);
+K_TIMER_DEFINE(postcode_holdoff, postcode_holdoff_expired, NULL);
+static atomic_t postcode_deferred;
 /* Postcode requested to be displayed */
 static uint8_t port80_code;
 static uint8_t port81_code;
@@ -34,10 +47,113 @@ static uint8_t led_cntr;
 /* Port80 display format */
 #define WORD_FROM_PORTS(p81, p80) ((p81 << 8) | p80)
 
+#ifdef CONFIG_POSTCODE_HISTORY
+#define HIST_ENTRIES		CONFIG_POSTCODE_HISTORY_ENTRIES
+
+struct __packed postcode_rec {
+	/* Relative to last platform reset */
+	uint32_t time_us;
+	uint8_t port;
+	uint8_t code;
+};
+
+/* History is exported oldest first after this header */
+#define HIST_HDR_SIZE		12u
+#define HIST_REC_SIZE		sizeof(struct postcode_rec)
+
+static struct postcode_rec history[HIST_ENTRIES];
+/* Total postcodes recorded since platform reset */
+static uint32_t hist_count;
+static int64_t hist_start;
+static struct k_spinlock hist_lock;
+
+/* History snapshot being read by the host */
+static uint32_t view_count;
+
+static void history_add(uint8_t port_index, uint8_t code)
+{
+	k_spinlock_key_t key = k_spin_lock(&hist_lock);
+	struct postcode_rec *rec = &history[hist_count % HIST_ENTRIES];
+
+	rec->time_us = k_ticks_to_us_floor32(k_uptime_ticks() - hist_start);
+	rec->port = port_index;
+	rec->code = code;
+	hist_count++;
+
+	k_spin_unlock(&hist_lock, key);
+}
+
+void postcode_history_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&hist_lock);
+
+	hist_count = 0;
+	hist_start = k_uptime_ticks();
+
+	k_spin_unlock(&hist_lock, key);
+}
+
+static uint8_t history_stream_byte(uint32_t count, uint32_t ofs)
+{
+	uint32_t stored = MIN(count, HIST_ENTRIES);
+	uint32_t dropped = count - stored;
+	uint32_t idx;
+
+	if (ofs < HIST_HDR_SIZE) {
+		uint8_t hdr[HIST_HDR_SIZE] = {
+			POSTCODE_HIST_MAGIC & 0xFF, POSTCODE_HIST_MAGIC >> 8,
+			POSTCODE_HIST_VERSION, HIST_REC_SIZE,
+			stored & 0xFF, stored >> 8,
+			HIST_ENTRIES & 0xFF, HIST_ENTRIES >> 8,
+			dropped & 0xFF, (dropped >> 8) & 0xFF,
+			(dropped >> 16) & 0xFF, dropped >> 24,
+		};
+
+		return hdr[ofs];
+	}
+
+	ofs -= HIST_HDR_SIZE;
+	idx = ofs / HIST_REC_SIZE;
+	if (idx >= stored) {
+		return 0xFF;
+	}
+
+	idx = (dropped + idx) % HIST_ENTRIES;
+
+	return ((uint8_t *)&history[idx])[ofs % HIST_REC_SIZE];
+}
+
+void postcode_history_read_chunk(uint16_t chunk, uint8_t *buf)
+{
+	uint32_t ofs = chunk * POSTCODE_HIST_CHUNK_SIZE;
+	k_spinlock_key_t key = k_spin_lock(&hist_lock);
+
+	/* Reading first chunk starts a new readout, later postcodes are
+	 * not part of it.
+	 */
+	if (chunk == 0 || view_count > hist_count) {
+		view_count = hist_count;
+	}
+
+	for (uint8_t i = 0; i < POSTCODE_HIST_CHUNK_SIZE; i++) {
+		buf[i] = history_stream_byte(view_count, ofs + i);
+	}
+
+	k_spin_unlock(&hist_lock, key);
+}
+#else
+static inline void history_add(uint8_t port_index, uint8_t code) {}
+#endif /* CONFIG_POSTCODE_HISTORY */
+
 static void signal_request(void)
 {
-	if (k_sem_count_get(&update_lock) == 0) {
-		k_sem_give(&update_lock);
+	ec_task_post(&postcode_task, POSTCODE_EVT_UPDATE);
+}
+
+static void postcode_holdoff_expired(struct k_timer *timer)
+{
+	if (atomic_clear(&postcode_deferred)) {
+		signal_request();
 	}
 }
 
@@ -52,6 +168,8 @@ static void update_postcode(uint8_t port_index, uint8_t code)
 {
 	bool update_pending = false;
 
+	history_add(port_index, code);
+
 	switch (port_index) {
 	case POSTCODE_PORT80:
 		if (port80_code != code) {
@@ -129,11 +247,21 @@ void postcode_thread(void *p1, void *p2, void *p3)
 	}
 
 	espihub_add_postcode_handler(update_postcode);
-	k_sem_init(&update_lock, 0, 1);
-
 	while (true) {
 		/* Wait until postcode update is received */
-		k_sem_take(&update_lock, K_FOREVER);
+		ec_task_wait(&postcode_task);
+
+		/* Bound display refresh rate, postcodes received meanwhile
+		 * are accumulated and only the latest one is displayed.
+		 * Deferral is flagged before checking the timer so that an
+		 * expiry in between still reposts the update.
+		 */
+		atomic_set(&postcode_deferred, 1);
+		if (k_timer_remaining_ticks(&postcode_holdoff)) {
+			continue;
+		}
+		atomic_clear(&postcode_deferred);
+
 		if (err_code) {
 			port80_code = err_code;
 			port81_code = BOARD_ERR_INDICATOR;
@@ -142,8 +270,15 @@ void postcode_thread(void *p1, void *p2, void *p3)
 			port80_display_word(disp_word);
 			LOG_DBG("Post:%04x", disp_word);
 
+#if defined(CONFIG_BINLOG) && !defined(CONFIG_LOG_BACKEND_UART)
+			/* Panic would make all later logs synchronous, dump the
+			 * binary log from a low priority thread instead.
+			 */
+			binlog_dump_request();
+#else
 			/* Flush the log buffer */
 			LOG_PANIC();
+#endif
 #ifdef CONFIG_POWER_SEQUENCE_ERROR_LED
 			update_error_leds();
 #endif
@@ -155,5 +290,9 @@ void postcode_thread(void *p1, void *p2, void *p3)
 			port80_display_word(disp_word);
 			LOG_DBG("PostCode:%04x", disp_word);
 		}
+
+		k_timer_start(&postcode_holdoff,
+			      K_MSEC(CONFIG_POSTCODE_DISPLAY_PERIOD_MS),
+			      K_NO_WAIT);
 	}
 }
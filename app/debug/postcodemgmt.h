@@ -33,4 +33,33 @@ void postcode_thread(void *p1, void *p2, void *p3);
  */
 void update_error(uint8_t errcode);
 
+/* History is exported as a byte stream, keep in sync with host tools */
+#define POSTCODE_HIST_MAGIC		0x4350
+#define POSTCODE_HIST_VERSION		1u
+
+/* Host reads the history in chunks of this size via SMC */
+#define POSTCODE_HIST_CHUNK_SIZE	8u
+
+#ifdef CONFIG_POSTCODE_HISTORY
+/**
+ * @brief Clear postcode history, called on platform reset.
+ */
+void postcode_history_reset(void);
+
+/**
+ * @brief Read a chunk of postcode history.
+ *
+ * History starts with a 12 bytes header: magic, version, record size,
+ * number of records, capacity and number of overwritten records. Records
+ * follow oldest first. Reading chunk 0 snapshots the number of records.
+ *
+ * @param chunk chunk index.
+ * @param buf buffer of POSTCODE_HIST_CHUNK_SIZE bytes, bytes past the end
+ *	      of the history are returned as 0xFF.
+ */
+void postcode_history_read_chunk(uint16_t chunk, uint8_t *buf);
+#else
+static inline void postcode_history_reset(void) {}
+#endif
+
 #endif /* __POSTCODE_MGMT_H__ */
@@ -12,6 +12,7 @@
 #include "espi_hub.h"
 #include "kbs_matrix.h"
 #include "pwrplane.h"
+#include "pwrseq_notify.h"
 #include "board_config.h"
 #include <logging/log.h>
 LOG_MODULE_REGISTER(kbchost, CONFIG_KBCHOST_LOG_LEVEL);
@@ -535,12 +536,30 @@ void to_from_host_thread(void *p1, void *p2, void *p3)
 	}
 }
 
+/* Host suspended to RAM, possibly in deep S3, key press wakes it up */
+static bool kb_wake_host;
+
+static void kb_pstate_entry(enum pwrseq_pstate state,
+			    enum pwrseq_pstate prev)
+{
+	kb_wake_host = (state == PWRSEQ_PSTATE_S3) ||
+		       ((state == PWRSEQ_PSTATE_DEEPSX) && kb_wake_host);
+}
+
+static struct pwrseq_notifier kb_notifier = {
+	.states = PWRSEQ_PSTATE_ALL_MASK,
+	.entry = kb_pstate_entry,
+};
+
 void to_host_kb_thread(void *p1, void *p2, void *p3)
 {
 	uint32_t kb_data;
 	uint32_t host_char;
 	uint8_t obf_retries = 0;
 
+	pwrseq_notify_register(&kb_notifier);
+	kb_wake_host = (pwrseq_notify_state() == PWRSEQ_PSTATE_S3);
+
 	while (true) {
 		k_sem_take(&kb_p60_sem, K_FOREVER);
 		while (true) {
@@ -572,7 +591,7 @@ void to_host_kb_thread(void *p1, void *p2, void *p3)
 					/* Wake the Host if system is in S3 on
 					 * detection of first key press.
 					 */
-					if (pwrseq_system_state() == SYSTEM_S3_STATE) {
+					if (kb_wake_host) {
 						smc_generate_wake(WAKE_KBC_EVENT);
 					}
 					/* Send more kb data to the host */
@@ -10,57 +10,62 @@
 #include <soc.h>
 #include <logging/log.h>
 #include "gpio_ec.h"
+#include "gpio_snapshot.h"
 #include "periphmgmt.h"
 #include "pwrbtnmgmt.h"
 #include "board_config.h"
 #include "acpi_region.h"
 #include "smchost.h"
+#include "task_handler.h"
 LOG_MODULE_DECLARE(periph, CONFIG_PERIPHERAL_LOG_LEVEL);
 
-/* Debouncing is performed in 1 ms intervals.
- * Maximum debounce count is the debounce time specified in milliseconds.
- */
-#define GPIO_DEBOUNCE_CNT	CONFIG_PERIPHERAL_DEBOUNCE_TIME
+/* Default time a button level needs to be stable after its last edge */
+#define BTN_STABLE_MS		CONFIG_PERIPHERAL_DEBOUNCE_TIME
+/* Default minimum pulse width, shorter pulses are filtered out */
+#define BTN_GLITCH_MS		CONFIG_PERIPHERAL_GLITCH_FILTER_TIME
 
 struct btn_info {
 	uint32_t		port_pin;
-	bool		debouncing;
-	uint8_t		deb_cnt;
 	btn_handler_t	handler;
 	bool		prev_level;
 	struct gpio_callback gpio_cb;
 	char		*name;
+	uint16_t	stable_ms;
+	uint16_t	glitch_ms;
+	bool		debouncing;
+	/* Uptime in ticks of first edge of current bounce burst */
+	int64_t		first_edge;
+	struct k_timer	deb_timer;
 };
 
+#define BTN(_port_pin, _init_level, _name)				\
+	{ .port_pin = (_port_pin), .prev_level = (_init_level),	\
+	  .name = (_name), .stable_ms = BTN_STABLE_MS,			\
+	  .glitch_ms = BTN_GLITCH_MS }
+
 static struct btn_info btn_lst[] = {
-	{VOL_UP,          false, GPIO_DEBOUNCE_CNT, NULL, VOL_UP_INIT_POS,
-					{{0}, NULL, 0}, "VolUp"},
-	{PWRBTN_EC_IN_N,  false, GPIO_DEBOUNCE_CNT, NULL, PWR_BTN_INIT_POS,
-					{{0}, NULL, 0}, "PwrBtn"},
-	{VOL_DOWN,        false, GPIO_DEBOUNCE_CNT, NULL, VOL_DN_INIT_POS,
-					{{0}, NULL, 0}, "VolDown"},
-	{HOME_BUTTON,		false, GPIO_DEBOUNCE_CNT, NULL, HOME_INIT_POS,
-					{{0}, NULL, 0}, "hmbtn"},
-	{SMC_LID,        false, GPIO_DEBOUNCE_CNT, NULL, LID_INIT_POS,
-					{{0}, NULL, 0}, "LidBtn"},
+	BTN(VOL_UP, VOL_UP_INIT_POS, "VolUp"),
+	BTN(PWRBTN_EC_IN_N, PWR_BTN_INIT_POS, "PwrBtn"),
+	BTN(VOL_DOWN, VOL_DN_INIT_POS, "VolDown"),
+	BTN(HOME_BUTTON, HOME_INIT_POS, "hmbtn"),
+	BTN(SMC_LID, LID_INIT_POS, "LidBtn"),
 #if defined(VIRTUAL_BAT) || defined(VIRTUAL_DOCK)
-	{VIRTUAL_BAT,    false, GPIO_DEBOUNCE_CNT, NULL, VIRTUAL_BAT_INIT_POS,
-					{{0}, NULL, 0}, "VirBat"},
-	{VIRTUAL_DOCK,   false, GPIO_DEBOUNCE_CNT, NULL, VIRTUAL_DOCK_INIT_POS,
-					{{0}, NULL, 0}, "VirDock"},
+	BTN(VIRTUAL_BAT, VIRTUAL_BAT_INIT_POS, "VirBat"),
+	BTN(VIRTUAL_DOCK, VIRTUAL_DOCK_INIT_POS, "VirDock"),
 #endif
 #ifdef EC_SLATEMODE_HALLOUT_SNSR_R
-	{EC_SLATEMODE_HALLOUT_SNSR_R, false, GPIO_DEBOUNCE_CNT, NULL,
-				SLATEMODE_INIT_POS, {{0}, NULL, 0}, "Slatesw"},
+	BTN(EC_SLATEMODE_HALLOUT_SNSR_R, SLATEMODE_INIT_POS, "Slatesw"),
 #endif
 #if defined(CONFIG_SOC_DEBUG_AWARENESS) && defined(TIMEOUT_DISABLE)
-	{TIMEOUT_DISABLE, false, GPIO_DEBOUNCE_CNT, NULL, 1,
-					{{0}, NULL, 0}, "Timeout"},
+	BTN(TIMEOUT_DISABLE, 1, "Timeout"),
 #endif
 };
 
-static int debouncing_ongoing;
-static struct k_sem btn_debounce_lock;
+/* Posted events are the buttons whose debounce deadline expired */
+BUILD_ASSERT(BIT(ARRAY_SIZE(btn_lst) - 1) & EC_TASK_EVT_MASK,
+	     "Too many buttons");
+
+static EC_TASK_DEFINE(periph_task, "PERIPH", 0, 0, EC_TASK_PSTATE_ANY);
 
 static void notify_btn_handlers(uint8_t btn_idx)
 {
@@ -73,7 +78,9 @@ static void notify_btn_handlers(uint8_t btn_idx)
 		return;
 	}
 
-	LOG_DBG("Btn[%s] valid change: %x", btn_lst[btn_idx].name, level);
+	LOG_DBG("Btn[%s] valid change: %x after %d us", btn_lst[btn_idx].name,
+		level, (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks() -
+					btn_lst[btn_idx].first_edge));
 
 	/* Ignore the button events if the debounce timings are not satisfied.
 	 * This will address cases when input signal is noisy.
@@ -89,45 +96,51 @@ static void notify_btn_handlers(uint8_t btn_idx)
 
 /* Single callback to handle all button change events.
  * Buttons can be identified using container of gpio_cb structure.
+ *
+ * Every edge pushes the debounce deadline so it expires once the level
+ * is stable for stable_ms, and not before glitch_ms after the first edge
+ * of the burst. A pulse shorter than glitch_ms is back to the previous
+ * level at the deadline and never reported.
  */
 static void gpio_level_change_callback(const struct device *dev,
 		     struct gpio_callback *gpio_cb, uint32_t pins)
 {
 	struct btn_info *info = CONTAINER_OF(gpio_cb, struct btn_info, gpio_cb);
+	int64_t now = k_uptime_ticks();
+	int64_t deadline;
 
-	LOG_DBG("%s level changed, starting debounce", info->name);
-	info->debouncing = true;
-	info->deb_cnt = GPIO_DEBOUNCE_CNT;
-
+	if (!info->debouncing) {
+		info->debouncing = true;
+		info->first_edge = now;
+	}
 
-	k_sem_give(&btn_debounce_lock);
+	deadline = MAX(now + k_ms_to_ticks_ceil64(info->stable_ms),
+		       info->first_edge + k_ms_to_ticks_ceil64(info->glitch_ms));
+	k_timer_start(&info->deb_timer, K_TIMEOUT_ABS_TICKS(deadline),
+		      K_NO_WAIT);
 }
 
-static void debounce_pins(void)
+static void debounce_expiry(struct k_timer *timer)
 {
-	debouncing_ongoing = 0;
-
-	for (int i = 0; i < ARRAY_SIZE(btn_lst); i++) {
-		if (btn_lst[i].debouncing) {
-			btn_lst[i].deb_cnt--;
+	struct btn_info *info = CONTAINER_OF(timer, struct btn_info,
+					     deb_timer);
 
-			if (btn_lst[i].deb_cnt == 0) {
-				btn_lst[i].debouncing = false;
-				btn_lst[i].deb_cnt = GPIO_DEBOUNCE_CNT;
-				notify_btn_handlers(i);
-			}
-		}
+	info->debouncing = false;
+	ec_task_post(&periph_task, BIT(info - btn_lst));
+}
 
-		if (btn_lst[i].debouncing) {
-			debouncing_ongoing++;
+int periph_set_button_debounce(uint32_t port_pin, uint16_t stable_ms,
+			       uint16_t glitch_ms)
+{
+	for (int i = 0; i < ARRAY_SIZE(btn_lst); i++) {
+		if (btn_lst[i].port_pin == port_pin) {
+			btn_lst[i].stable_ms = stable_ms;
+			btn_lst[i].glitch_ms = glitch_ms;
+			return 0;
 		}
 	}
-}
 
-bool is_debouncing(void)
-{
-	LOG_INF("%s :%d ", __func__, debouncing_ongoing);
-	return (debouncing_ongoing > 0);
+	return -EINVAL;
 }
 
 static int periph_add_gpio_cb_for_button(int btn_index)
@@ -135,6 +148,8 @@ static int periph_add_gpio_cb_for_button(int btn_index)
 	struct btn_info *info = &btn_lst[btn_index];
 	int ret;
 
+	k_timer_init(&info->deb_timer, debounce_expiry, NULL);
+
 	ret = gpio_init_callback_pin(info->port_pin, &info->gpio_cb,
 			       gpio_level_change_callback);
 	if (ret) {
@@ -200,14 +215,14 @@ void update_virtual_bat_dock_status(void)
 {
 	int level;
 
-	level = gpio_read_pin(VIRTUAL_BAT);
+	level = gpio_snapshot_get(VIRTUAL_BAT);
 	if (level < 0) {
 		LOG_ERR("Fail to read virtual battery io expander");
 	} else {
 		g_acpi_tbl.acpi_flags2.vb_sw_closed = (level > 0) ? level : 0;
 	}
 
-	level = gpio_read_pin(VIRTUAL_DOCK);
+	level = gpio_snapshot_get(VIRTUAL_DOCK);
 	if (level < 0) {
 		LOG_ERR("Fail to read virtual dock io expander");
 	} else {
@@ -229,19 +244,21 @@ bool is_virtual_dock_prsnt(void)
 
 void periph_thread(void *p1, void *p2, void *p3)
 {
-	uint32_t period = *(uint32_t *)p1;
+	uint32_t ready;
 
 	pwrbtn_init();
 
-	k_sem_init(&btn_debounce_lock, 0, 1);
+	/* Switches are only sampled by the snapshot service */
+	gpio_snapshot_add_pin(VIRTUAL_BAT, CONFIG_PERIPHERAL_DEBOUNCE_TIME);
+	gpio_snapshot_add_pin(VIRTUAL_DOCK, CONFIG_PERIPHERAL_DEBOUNCE_TIME);
+
 	while (true) {
-		/* Wait until ISR occurs to start debouncing */
-		k_sem_take(&btn_debounce_lock, K_FOREVER);
-
-		do {
-			/* Perform debounce for all buttons */
-			k_msleep(period);
-			debounce_pins();
-		} while (is_debouncing());
+		/* Wait until a button debounce deadline expires */
+		ready = ec_task_wait(&periph_task);
+		for (int i = 0; i < ARRAY_SIZE(btn_lst); i++) {
+			if (ready & BIT(i)) {
+				notify_btn_handlers(i);
+			}
+		}
 	}
 }
@@ -56,4 +56,20 @@ void periph_thread(void *p1, void *p2, void *p3);
  */
 int periph_register_button(uint32_t port_pin, btn_handler_t handler);
 
+/**
+ * @brief Override debounce settings of a button.
+ *
+ * A button change is reported once its level is stable for stable_ms after
+ * the last edge, and no sooner than glitch_ms after the first edge. Pulses
+ * shorter than glitch_ms are filtered out.
+ *
+ * @param port_pin the button encoded port/pin.
+ * @param stable_ms time the level must be stable after the last edge.
+ * @param glitch_ms minimum pulse width reported.
+ *
+ * @retval 0 if successful, -EINVAL if button is unknown.
+ */
+int periph_set_button_debounce(uint32_t port_pin, uint16_t stable_ms,
+			       uint16_t glitch_ms);
+
 #endif /* __PWRBTN_MGMT_H__ */
@@ -20,6 +20,7 @@
 #include "pwrplane.h"
 #include "pwrbtnmgmt.h"
 #include "pwrseq_timeouts.h"
+#include "pwrseq_notify.h"
 #include <logging/log.h>
 LOG_MODULE_REGISTER(deepsx, CONFIG_PWRMGMT_DEEPSX_LOG_LEVEL);
 
@@ -100,6 +101,7 @@ static bool enter_deeps3(void)
 	}
 
 	sys_deep_sx = true;
+	pwrseq_notify_update();
 
 	/* Note this requires to disable automatic SUS_ACK from eSPI driver */
 	wait_for_pin(gpio_deva, PM_SLP_SUS, PM_SLP_SUS_TIMEOUT, 0);
@@ -200,6 +202,7 @@ static bool exit_deeps4(void)
 	}
 
 	sys_deep_sx = false;
+	pwrseq_notify_update();
 
 	return true;
 }
@@ -388,6 +391,7 @@ void deep_sx_enter(void)
 			gpio_write_pin(PM_DS3, 1);
 		}
 		sys_deep_sx = true;
+		pwrseq_notify_update();
 	}
 }
 
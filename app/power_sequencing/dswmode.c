@@ -7,6 +7,7 @@
 #include <zephyr.h>
 #include <device.h>
 #include "eeprom.h"
+#include "ec_settings.h"
 #include "errcodes.h"
 #include "dswmode.h"
 #include <logging/log.h>
@@ -49,7 +50,10 @@ void dsw_update_mode(uint8_t mode)
 	dsw_mode_update = true;
 }
 
-void dsw_read_mode(void)
+/* Deep Sx mode used to be saved at a fixed EEPROM offset, it is moved to the
+ * settings store the first time it is read.
+ */
+static int dsw_read_legacy_mode(uint8_t *mode)
 {
 	int ret;
 	uint16_t value;
@@ -57,22 +61,43 @@ void dsw_read_mode(void)
 	ret = eeprom_read_word(EEPROM_DSW_OFFSET, &value);
 	if (ret) {
 		LOG_ERR("Unable to read EEPROM %d", ret);
-		return;
+		return ret;
 	}
 
 	LOG_DBG("Read EEPROM dsw config: %x", value);
 
-	if (value & DSW_VALID_MASK) {
-		dsw_valid_config = value & DSW_MODE_MASK;
+	if ((value & ~DSW_MODE_MASK) != DSW_VALID_MASK) {
+		return -ENOENT;
+	}
+
+	*mode = value & DSW_MODE_MASK;
 
-		LOG_DBG("dsw_mode %x", dsw_valid_config);
-		LOG_DBG("dsw_enabled %x", dsw_enabled());
+	return ec_settings_set(EC_SETTING_DSW_MODE, mode, sizeof(*mode));
+}
+
+void dsw_read_mode(void)
+{
+	int ret;
+	uint8_t mode;
+
+	ret = ec_settings_get(EC_SETTING_DSW_MODE, &mode, sizeof(mode));
+	if (ret == -ENOENT) {
+		ret = dsw_read_legacy_mode(&mode);
+	}
+
+	if (ret < 0) {
+		return;
 	}
+
+	dsw_valid_config = mode;
+
+	LOG_DBG("dsw_mode %x", dsw_valid_config);
+	LOG_DBG("dsw_enabled %x", dsw_enabled());
 }
 
 void dsw_save_mode(void)
 {
-	uint16_t data;
+	int ret;
 
 	if (dsw_mode_update) {
 		dsw_mode_update = false;
@@ -80,11 +105,13 @@ void dsw_save_mode(void)
 		if (dsw_tmp_config != dsw_valid_config) {
 			dsw_valid_config = dsw_tmp_config;
 
-			data = (dsw_valid_config & DSW_MODE_MASK) |
-				DSW_VALID_MASK;
 			LOG_DBG("dsw_enabled %x", dsw_enabled());
-			LOG_DBG("Save %x to EEPROM", data);
-			eeprom_write_word(EEPROM_DSW_OFFSET, data);
+			ret = ec_settings_set(EC_SETTING_DSW_MODE,
+					      &dsw_valid_config,
+					      sizeof(dsw_valid_config));
+			if (ret) {
+				LOG_ERR("Unable to save dsw config %d", ret);
+			}
 		}
 	}
 }
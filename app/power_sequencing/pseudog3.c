@@ -11,6 +11,7 @@
 #include "board_config.h"
 #include "pwrplane.h"
 #include "pseudog3.h"
+#include "pwrseq_notify.h"
 #include "espi_hub.h"
 #include "periphmgmt.h"
 #include "pwrbtnmgmt.h"
@@ -47,6 +48,8 @@ static void counter_expired_hndlr(struct k_timer *counter);
 K_TIMER_DEFINE(pg3_counter_dc, counter_expired_hndlr, NULL);
 static bool pg3_generate_wake;
 static bool pg3_enable_status;
+/* Host in S4/S5, possibly in deep Sx */
+static bool pg3_host_off;
 
 static bool is_pseudo_g3_condition(void)
 {
@@ -163,13 +166,8 @@ static void pg3_handle_state_idle(void)
 		return;
 	}
 
-	switch (pwrseq_system_state()) {
-	case SYSTEM_S4_STATE:
-	case SYSTEM_S5_STATE:
+	if (pg3_host_off) {
 		pseudo_g3_set_state(PG3_STATE_WAITING_ENTRY);
-		return;
-	default:
-		break;
 	}
 	/* Default continue in PG3_STATE_IDLE */
 }
@@ -180,29 +178,20 @@ static void pg3_handle_state_waiting_entry(void)
 	 * 2. Move to PG3_STATE_ENTERED if pg3 condition meet.
 	 * 3. Continue in PG3_STATE_WAITING_ENTRY if pg3 not condition meet.
 	 */
-	switch (pwrseq_system_state()) {
-	case SYSTEM_S0_STATE:
-	case SYSTEM_S3_STATE:
-	case SYSTEM_G3_STATE:
+	if (!pg3_host_off) {
 		pseudo_g3_set_state(PG3_STATE_IDLE);
 		return;
-	case SYSTEM_S4_STATE:
-	case SYSTEM_S5_STATE:
-		/* If PG3 condition meet, then move to
-		 * PG3_STATE_ENTERED state
-		 */
-		if (is_pseudo_g3_condition()) {
-			LOG_DBG("Entering Pseudo G3 state");
-			/* drive Hw signal to enter PG3 */
-			gpio_write_pin(PM_DS3, 1);
-			k_msleep(10);
-			gpio_write_pin(PM_DS3, 0);
-
-			pseudo_g3_set_state(PG3_STATE_ENTERED);
-			return;
-		}
-	default:
-		break;
+	}
+
+	/* If PG3 condition meet, then move to PG3_STATE_ENTERED state */
+	if (is_pseudo_g3_condition()) {
+		LOG_DBG("Entering Pseudo G3 state");
+		/* drive Hw signal to enter PG3 */
+		gpio_write_pin(PM_DS3, 1);
+		k_msleep(10);
+		gpio_write_pin(PM_DS3, 0);
+
+		pseudo_g3_set_state(PG3_STATE_ENTERED);
 	}
 	/* Default continue in PG3_STATE_WAITING_ENTRY */
 }
@@ -215,34 +204,25 @@ static void pg3_handle_state_entered(void)
 	 *    Move to PG3_STATE_WAKE_WAIT till system move to S0/S3
 	 * 4. Else Continue in PG3_STATE_ENTERED as pg3 condition meet.
 	 */
-	switch (pwrseq_system_state()) {
-	case SYSTEM_S0_STATE:
-	case SYSTEM_S3_STATE:
-	case SYSTEM_G3_STATE:
+	if (!pg3_host_off) {
 		pseudo_g3_set_state(PG3_STATE_IDLE);
 		return;
-	case SYSTEM_S4_STATE:
-	case SYSTEM_S5_STATE:
-		/* If PG3 condition not meet, then move to
-		 * PG3_STATE_WAITING_ENTRY state and from that state
-		 * move appropriately.
-		 */
-
-		/* wake due to power adapter insertion in PG3 */
-		if ((gpio_read_pin(BC_ACOK) > 0)
-			&& (!is_virtual_battery_prsnt())) {
-			LOG_DBG("No Pseudo G3 with AC present.");
-			pseudo_g3_set_state(PG3_STATE_WAITING_ENTRY);
-			return;
-		}
+	}
 
-		if (gpio_read_pin(PM_RSMRST) > 0) {
-			LOG_DBG("PG3 Wake triggered");
-			pseudo_g3_set_state(PG3_STATE_WAKE_WAIT);
-			return;
-		}
-	default:
-		break;
+	/* If PG3 condition not meet, then move to PG3_STATE_WAITING_ENTRY
+	 * state and from that state move appropriately.
+	 */
+
+	/* wake due to power adapter insertion in PG3 */
+	if ((gpio_read_pin(BC_ACOK) > 0) && (!is_virtual_battery_prsnt())) {
+		LOG_DBG("No Pseudo G3 with AC present.");
+		pseudo_g3_set_state(PG3_STATE_WAITING_ENTRY);
+		return;
+	}
+
+	if (gpio_read_pin(PM_RSMRST) > 0) {
+		LOG_DBG("PG3 Wake triggered");
+		pseudo_g3_set_state(PG3_STATE_WAKE_WAIT);
 	}
 	/* Default continue in PG3_STATE_ENTERED */
 }
@@ -252,14 +232,8 @@ static void pg3_handle_state_wake_wait(void)
 	/* Move to PG3_STATE_IDLE if system transition to S0/S3.
 	 * else continue in PG3_STATE_WAKE_WAIT.
 	 */
-	switch (pwrseq_system_state()) {
-	case SYSTEM_S0_STATE:
-	case SYSTEM_S3_STATE:
-	case SYSTEM_G3_STATE:
+	if (!pg3_host_off) {
 		pseudo_g3_set_state(PG3_STATE_IDLE);
-		break;
-	default:
-		break;
 	}
 	/* Default continue in PG3_STATE_WAKE_WAIT */
 }
@@ -293,6 +267,24 @@ static void manage_pseudog3_states(void)
 	}
 }
 
+static void pg3_pstate_entry(enum pwrseq_pstate state,
+			     enum pwrseq_pstate prev)
+{
+	pg3_host_off = (state == PWRSEQ_PSTATE_S4) ||
+		       (state == PWRSEQ_PSTATE_S5) ||
+		       ((state == PWRSEQ_PSTATE_DEEPSX) && pg3_host_off);
+}
+
+static struct pwrseq_notifier pg3_notifier = {
+	.states = PWRSEQ_PSTATE_ALL_MASK,
+	.entry = pg3_pstate_entry,
+};
+
+void pseudo_g3_init(void)
+{
+	pwrseq_notify_register(&pg3_notifier);
+}
+
 void pseudo_g3_enable(bool status)
 {
 	pg3_enable_status = status;
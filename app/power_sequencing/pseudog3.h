@@ -45,6 +45,11 @@ bool pseudo_g3_get_prev_state(void);
  */
 void pseudo_g3_program_counter(enum pg3_counter counter, uint32_t count);
 
+/**
+ * @brief Initialize pseudo g3, tracks host power state.
+ */
+void pseudo_g3_init(void);
+
 /**
  * @brief Manage pseudo g3 state.
  *
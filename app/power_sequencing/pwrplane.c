@@ -10,8 +10,9 @@
 #include <drivers/espi.h>
 #include <logging/log.h>
 #include "gpio_ec.h"
+#include "gpio_ec_fast.h"
+#include "gpio_snapshot.h"
 #include "espi_hub.h"
-#include "espioob_mngr.h"
 #ifdef CONFIG_ESPI_SAF
 #include "saf_config.h"
 #endif
@@ -31,6 +32,9 @@
 #include "soc_debug.h"
 #endif
 #include "pwrseq_timeouts.h"
+#include "pwrseq_events.h"
+#include "pwrseq_trace.h"
+#include "pwrseq_notify.h"
 #include "errcodes.h"
 #ifdef CONFIG_SOC_FAMILY_MEC
 #include "vci.h"
@@ -44,6 +48,7 @@
 #include "dnx.h"
 #endif
 #include "eeprom.h"
+#include "peci_hub.h"
 
 LOG_MODULE_REGISTER(pwrmgmt, CONFIG_PWRMGT_LOG_LEVEL);
 
@@ -222,66 +227,112 @@ static void handle_spi_sharing(uint8_t boot_mode)
 	}
 }
 
-static int wait_for_pin_level(uint32_t port_pin, uint16_t timeout,
-			uint32_t exp_level)
-{
-	uint16_t loop_cnt = timeout;
+struct pin_cond {
+	uint32_t port_pin;
+	uint32_t exp_level;
 	int level;
+};
 
-	do {
-		/* Passes the enconded gpio(port_pin) to the gpio driver */
-		level = gpio_read_pin(port_pin);
-		if (level < 0) {
-			LOG_ERR("Failed to read %x ", gpio_get_pin(port_pin));
-			return -EIO;
-		}
+static int pin_level_cond(void *arg)
+{
+	struct pin_cond *pin = arg;
 
-		if (exp_level == level) {
-			LOG_DBG("Pin [%o]: %x",
-				get_absolute_gpio_num(port_pin), exp_level);
-			break;
-		}
+	/* Passes the enconded gpio(port_pin) to the gpio driver */
+	pin->level = gpio_fast_read_pin(pin->port_pin);
+	if (pin->level < 0) {
+		LOG_ERR("Failed to read %x ", gpio_get_pin(pin->port_pin));
+		return -EIO;
+	}
 
-		k_usleep(100);
-		loop_cnt--;
-	} while (loop_cnt > 0 || (timeout == PWR_SEQ_TIMEOUT_FOREVER) ||
-		ec_timeout_status());
+	return pin->exp_level == pin->level;
+}
 
-	if (loop_cnt == 0) {
-		LOG_DBG("Timeout [%x]: %x", gpio_get_pin(port_pin), level);
-		return -ETIMEDOUT;
+static int wait_for_pin_level(uint32_t port_pin, uint16_t timeout,
+			uint32_t exp_level)
+{
+	int ret;
+	struct pin_cond pin = {
+		.port_pin = port_pin,
+		.exp_level = exp_level,
+	};
+
+	ret = pwrseq_wait_cond(pin_level_cond, &pin, timeout);
+	if (ret == -ETIMEDOUT) {
+		LOG_DBG("Timeout [%x]: %x", gpio_get_pin(port_pin), pin.level);
+	} else if (!ret) {
+		LOG_DBG("Pin [%o]: %x",
+			get_absolute_gpio_num(port_pin), exp_level);
 	}
 
-	return 0;
+	return ret;
+}
+
+static uint8_t pwrseq_trace_pin_id(uint32_t port_pin)
+{
+	if (port_pin == RSMRST_PWRGD) {
+		return PWRSEQ_TRACE_PIN_RSMRST_PWRGD;
+	} else if (port_pin == ESPI_RESET_MAF) {
+		return PWRSEQ_TRACE_PIN_ESPI_RESET;
+	} else if (port_pin == ALL_SYS_PWRGD) {
+		return PWRSEQ_TRACE_PIN_ALL_SYS_PWRGD;
+	} else if (port_pin == PWRBTN_EC_IN_N) {
+		return PWRSEQ_TRACE_PIN_PWRBTN;
+	} else if (port_pin == PM_SLP_SUS) {
+		return PWRSEQ_TRACE_PIN_SLP_SUS;
+#ifdef PWR_OK
+	} else if (port_pin == PWR_OK) {
+		return PWRSEQ_TRACE_PIN_PWR_OK;
+#endif
+	}
+
+	return PWRSEQ_TRACE_PIN_OTHER;
 }
 
 static inline int wait_for_pin(uint32_t port_pin, uint16_t timeout,
 			       uint32_t exp_level)
 {
+	int ret;
+	int64_t start = k_uptime_ticks();
+
 	if (pwrseq_timeout_disabled) {
 		timeout = PWR_SEQ_TIMEOUT_FOREVER;
 	}
 
-	return wait_for_pin_level(port_pin, timeout, exp_level);
+	ret = wait_for_pin_level(port_pin, timeout, exp_level);
+	pwrseq_trace_step(PWRSEQ_TRACE_SRC_GPIO, pwrseq_trace_pin_id(port_pin),
+			  get_absolute_gpio_num(port_pin), start, ret);
+	return ret;
 }
 
 static inline int wait_for_vwire(uint8_t signal, uint16_t timeout,
 				uint8_t exp_level, bool ack_req)
 {
+	int ret;
+	int64_t start = k_uptime_ticks();
+
 	if (pwrseq_timeout_disabled) {
 		timeout = PWR_SEQ_TIMEOUT_FOREVER;
 	}
 
-	return espihub_wait_for_vwire(signal, timeout, exp_level, ack_req);
+	ret = espihub_wait_for_vwire(signal, timeout, exp_level, ack_req);
+	pwrseq_trace_step(PWRSEQ_TRACE_SRC_VWIRE, signal, UINT8_MAX, start,
+			  ret);
+	return ret;
 }
 
 static inline int wait_for_espi_reset(uint8_t exp_sts, uint16_t timeout)
 {
+	int ret;
+	int64_t start = k_uptime_ticks();
+
 	if (pwrseq_timeout_disabled) {
 		timeout = PWR_SEQ_TIMEOUT_FOREVER;
 	}
 
-	return espihub_wait_for_espi_reset(exp_sts, timeout);
+	ret = espihub_wait_for_espi_reset(exp_sts, timeout);
+	pwrseq_trace_step(PWRSEQ_TRACE_SRC_ESPI_RST, exp_sts, UINT8_MAX, start,
+			  ret);
+	return ret;
 }
 
 static int check_slp_signals(void)
@@ -323,6 +374,7 @@ void pwrseq_error(uint8_t error_code)
 #ifdef CONFIG_POSTCODE_MANAGEMENT
 	update_error(error_code);
 #endif
+	pwrseq_trace_error(error_code);
 	k_msleep(100);
 	gpio_write_pin(PCH_PWROK, 0);
 	gpio_write_pin(SYS_PWROK, 0);
@@ -373,6 +425,8 @@ static inline int pwrseq_task_init(void)
 #endif /* CONFIG_POWER_SEQUENCE_DISABLE_TIMEOUTS */
 
 	handle_spi_sharing(espihub_boot_mode());
+	pwrseq_events_init();
+	pseudo_g3_init();
 	gpio_write_pin(PM_PWRBTN, 1);
 
 	#ifdef CONFIG_SOC_FAMILY_MEC
@@ -445,136 +499,119 @@ static inline int pwrseq_task_init(void)
 	return ret;
 }
 
-static bool pwrseq_handle_transition_to_s0(void)
+static int pwrseq_exit_sx(void)
 {
-	bool valid_transition = false;
 	int ret;
 
-	switch (current_state) {
-	case SYSTEM_G3_STATE: /* G3 -> S0 */
-	case SYSTEM_S5_STATE: /* S5 -> S0 */
-	case SYSTEM_S4_STATE: /* S4 -> S0 */
-		ret = check_slp_signals();
-		if (ret) {
-			LOG_ERR("SLP signal timeout error");
-			break;
-		}
-		ret = power_on();
-		if (ret) {
-			LOG_ERR("power_on() error");
-			break;
-		}
-		valid_transition = true;
-		break;
-	case SYSTEM_S3_STATE: /* S3 -> S0 */
-		ret = resume();
-		if (ret) {
-			LOG_ERR("resume() error");
-			break;
-		}
-		valid_transition = true;
-		break;
-	case SYSTEM_S0_STATE: /* S0 -> S0 */
-	default:
-		/* No action */
-		break;
+	ret = check_slp_signals();
+	if (ret) {
+		LOG_ERR("SLP signal timeout error");
+		return ret;
 	}
 
-	return valid_transition;
-}
-
-static bool pwrseq_handle_transition_to_s3(void)
-{
-	bool valid_transition = false;
-
-	switch (current_state) {
-	case SYSTEM_S0_STATE: /* S0 -> S3 */
-		suspend();
-		valid_transition = true;
-	case SYSTEM_G3_STATE: /* G3 -> S3 */
-	case SYSTEM_S5_STATE: /* S5 -> S3 */
-	case SYSTEM_S4_STATE: /* S4 -> S3 */
-		/* valid transition with no action */
-		valid_transition = true;
-		break;
-	case SYSTEM_S3_STATE: /* S3 -> S3 */
-	default:
-		break;
+	ret = power_on();
+	if (ret) {
+		LOG_ERR("power_on() error");
 	}
 
-	return valid_transition;
+	return ret;
 }
 
-static bool pwrseq_handle_transition_to_s4(void)
+static int pwrseq_resume(void)
 {
-	bool valid_transition = false;
+	int ret;
 
-	switch (current_state) {
-	case SYSTEM_S3_STATE: /* S3 -> S4 */
-	case SYSTEM_S0_STATE: /* S0 -> S4 */
-		power_off();
-		valid_transition = true;
-		break;
-	case SYSTEM_G3_STATE: /* G3 -> S4 */
-	case SYSTEM_S5_STATE: /* S5 -> S4 */
-		/* valid transition with no action */
-		valid_transition = true;
-		break;
-	case SYSTEM_S4_STATE: /* S4 -> S4 */
-	default:
-		break;
+	ret = resume();
+	if (ret) {
+		LOG_ERR("resume() error");
 	}
 
-	return valid_transition;
+	return ret;
 }
 
-static bool pwrseq_handle_transition_to_s5(void)
+static int pwrseq_suspend(void)
 {
-	bool valid_transition = false;
+	suspend();
+	return 0;
+}
 
-	switch (current_state) {
-	case SYSTEM_S3_STATE: /* S3 -> S5 */
-	case SYSTEM_S0_STATE: /* S0 -> S5 */
-		power_off();
-		valid_transition = true;
-		break;
-	case SYSTEM_G3_STATE: /* G3 -> S5 */
-	case SYSTEM_S4_STATE: /* S4 -> S5 */
-		/* valid transition with no action */
-		valid_transition = true;
-		break;
-	case SYSTEM_S5_STATE: /* S5 -> S5 */
-	default:
-		/* No action */
-		break;
-	}
-	return valid_transition;
+static int pwrseq_power_off(void)
+{
+	power_off();
+	return 0;
 }
 
+/**
+ * @brief Power state transition.
+ *
+ * Transitions not listed are unsupported, transitions without action are
+ * valid with no sequencing required.
+ */
+struct pwrseq_transition {
+	enum system_power_state from;
+	enum system_power_state to;
+	int (*action)(void);
+	enum pwrseq_trace_type trace;
+};
+
+static const struct pwrseq_transition pwrseq_transitions[] = {
+	{ SYSTEM_G3_STATE, SYSTEM_S0_STATE, pwrseq_exit_sx, PWRSEQ_TRACE_BOOT },
+	{ SYSTEM_S5_STATE, SYSTEM_S0_STATE, pwrseq_exit_sx, PWRSEQ_TRACE_BOOT },
+	{ SYSTEM_S4_STATE, SYSTEM_S0_STATE, pwrseq_exit_sx, PWRSEQ_TRACE_BOOT },
+	{ SYSTEM_S3_STATE, SYSTEM_S0_STATE, pwrseq_resume,
+	  PWRSEQ_TRACE_RESUME },
+
+	{ SYSTEM_S0_STATE, SYSTEM_S3_STATE, pwrseq_suspend,
+	  PWRSEQ_TRACE_SUSPEND },
+	{ SYSTEM_G3_STATE, SYSTEM_S3_STATE, NULL, PWRSEQ_TRACE_NONE },
+	{ SYSTEM_S5_STATE, SYSTEM_S3_STATE, NULL, PWRSEQ_TRACE_NONE },
+	{ SYSTEM_S4_STATE, SYSTEM_S3_STATE, NULL, PWRSEQ_TRACE_NONE },
+
+	{ SYSTEM_S3_STATE, SYSTEM_S4_STATE, pwrseq_power_off,
+	  PWRSEQ_TRACE_SHUTDOWN },
+	{ SYSTEM_S0_STATE, SYSTEM_S4_STATE, pwrseq_power_off,
+	  PWRSEQ_TRACE_SHUTDOWN },
+	{ SYSTEM_G3_STATE, SYSTEM_S4_STATE, NULL, PWRSEQ_TRACE_NONE },
+	{ SYSTEM_S5_STATE, SYSTEM_S4_STATE, NULL, PWRSEQ_TRACE_NONE },
+
+	{ SYSTEM_S3_STATE, SYSTEM_S5_STATE, pwrseq_power_off,
+	  PWRSEQ_TRACE_SHUTDOWN },
+	{ SYSTEM_S0_STATE, SYSTEM_S5_STATE, pwrseq_power_off,
+	  PWRSEQ_TRACE_SHUTDOWN },
+	{ SYSTEM_G3_STATE, SYSTEM_S5_STATE, NULL, PWRSEQ_TRACE_NONE },
+	{ SYSTEM_S4_STATE, SYSTEM_S5_STATE, NULL, PWRSEQ_TRACE_NONE },
+
+};
+
 static void pwrseq_update(void)
 {
 	bool valid_sx_transition = false;
+	const struct pwrseq_transition *t;
 
-	switch (next_state) {
-	case SYSTEM_S0_STATE:
-		valid_sx_transition = pwrseq_handle_transition_to_s0();
-		break;
-	case SYSTEM_S3_STATE:
-		valid_sx_transition = pwrseq_handle_transition_to_s3();
-		break;
-	case SYSTEM_S4_STATE:
-		valid_sx_transition = pwrseq_handle_transition_to_s4();
-		break;
-	case SYSTEM_S5_STATE:
-		valid_sx_transition = pwrseq_handle_transition_to_s5();
-		break;
-	default:
+	for (int i = 0; i < ARRAY_SIZE(pwrseq_transitions); i++) {
+		t = &pwrseq_transitions[i];
+		if (t->from != current_state || t->to != next_state) {
+			continue;
+		}
+
+		if (t->action == NULL) {
+			valid_sx_transition = true;
+			break;
+		}
+
+		pwrseq_trace_begin(t->trace);
+		valid_sx_transition = (t->action() == 0);
+		pwrseq_trace_end();
 		break;
 	}
 
 	if (valid_sx_transition) {
 		LOG_INF("System transition %d->%d", current_state, next_state);
+		if (current_state != next_state) {
+			peci_invalidate_cache();
+		}
 		current_state = next_state;
+		pwrseq_notify_update();
 	} else {
 		LOG_ERR("Unsupported next state: %d", next_state);
 		/* Do not transition to invalid state,
@@ -600,7 +637,7 @@ static bool pwrpln_check_power_adapter_levels(void)
 		return true;
 	}
 
-	if (gpio_read_pin(BC_ACOK)) {
+	if (gpio_snapshot_get(BC_ACOK) > 0) {
 		return true;
 	}
 
@@ -622,6 +659,31 @@ static void pwrpln_check_power_critical_levels(void)
 void set_next_state_to_S5(void)
 {
 	next_state = SYSTEM_S5_STATE;
+	pwrseq_evt_post(PWRSEQ_EVT_REQUEST);
+}
+
+/* No power sequencing expected, inputs are only re-evaluated on events or at
+ * low rate.
+ */
+static bool pwrseq_is_idle(void)
+{
+	if (next_state != current_state) {
+		return false;
+	}
+
+	/* Deep Sx handshake is still polled */
+	if (dsw_enabled()) {
+		return false;
+	}
+
+	switch (current_state) {
+	case SYSTEM_G3_STATE:
+	case SYSTEM_S4_STATE:
+	case SYSTEM_S5_STATE:
+		return true;
+	default:
+		return false;
+	}
 }
 
 void pwrseq_thread(void *p1, void *p2, void *p3)
@@ -629,16 +691,20 @@ void pwrseq_thread(void *p1, void *p2, void *p3)
 	int rsmrst_level;
 	uint32_t period = *(uint32_t *)p1;
 
+	pwrseq_trace_init();
+	pwrseq_trace_begin(PWRSEQ_TRACE_INIT);
 	pwrseq_task_init();
+	pwrseq_trace_end();
 	dsw_read_mode();
 
 	int hsid = hsid_read();
 	LOG_INF("HSID: %x\n", hsid);
 
 	while (true) {
-		k_msleep(period);
+		pwrseq_evt_wait_period(pwrseq_is_idle() ?
+				CONFIG_POWER_SEQUENCE_IDLE_PERIOD_MS : period);
 
-		rsmrst_level = gpio_read_pin(RSMRST_PWRGD);
+		rsmrst_level = gpio_snapshot_get(RSMRST_PWRGD);
 
 		if (rsmrst_level < 0) {
 			LOG_ERR("Failed to read RSMRST_PWRGD %d", rsmrst_level);
@@ -661,11 +727,11 @@ void pwrseq_thread(void *p1, void *p2, void *p3)
 		g_pwrflags.pm_rsmrst = rsmrst_level;
 
 		if (in_therm_shutdown == false) {
-			gpio_write_pin(PM_RSMRST, rsmrst_level);
+			gpio_fast_write_pin(PM_RSMRST, rsmrst_level);
 		}
 
 		/* Update AC present ACPI flag */
-		g_acpi_tbl.acpi_flags.ac_prsnt = gpio_read_pin(BC_ACOK);
+		g_acpi_tbl.acpi_flags.ac_prsnt = gpio_snapshot_get(BC_ACOK);
 
 		/* Check if power button was pressed */
 		if (g_pwrflags.turn_pwr_on) {
@@ -712,13 +778,6 @@ void pwrseq_thread(void *p1, void *p2, void *p3)
 
 		pwrpln_check_power_critical_levels();
 
-#ifndef CONFIG_ESPI_OOB_CHANNEL_RX_ASYNC
-		/*
-		 * When eSPI OOB RX callback is not enabled, downstream OOBs
-		 * need to be polled within the thread. This is blocking call.
-		 */
-		oob_rx_cb_handler();
-#endif
 		manage_pseudog3();
 	}
 }
@@ -749,6 +808,7 @@ void therm_shutdown(void)
 	while (true) {
 		if (gpio_read_pin(PWRBTN_EC_IN_N) == LOW) {
 			g_pwrflags.turn_pwr_on = true;
+			pwrseq_evt_post(PWRSEQ_EVT_REQUEST);
 			/* Rotate fan and toggle leds until pwr btn pressed */
 			break;
 		}
@@ -798,9 +858,7 @@ static void power_off(void)
 	board_suspend();
 
 	LOG_DBG("Shutting down %d", level);
-	do {
-		level = gpio_read_pin(PWRBTN_EC_IN_N);
-	} while (!level);
+	wait_for_pin(PWRBTN_EC_IN_N, PWR_SEQ_TIMEOUT_FOREVER, 1);
 
 #ifdef CONFIG_POSTCODE_MANAGEMENT
 	port80_display_off();
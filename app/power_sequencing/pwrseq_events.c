@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <logging/log.h>
+#include "gpio_ec.h"
+#include "gpio_snapshot.h"
+#include "espi_hub.h"
+#include "board_config.h"
+#include "pwrseq_utils.h"
+#include "pwrseq_events.h"
+#include "pwrseq_trace.h"
+#include "task_handler.h"
+
+LOG_MODULE_DECLARE(pwrmgmt, CONFIG_PWRMGT_LOG_LEVEL);
+
+/* Pending events are accumulated until next wait. Input re-evaluation is
+ * periodic, so it tolerates being delayed to share a wakeup with other tasks.
+ */
+static EC_TASK_DEFINE(pwrseq_task, "PWR", 0, 0, EC_TASK_PSTATE_ANY);
+
+static void pwrseq_gpio_handler(uint32_t changed, uint32_t levels)
+{
+	pwrseq_evt_post(PWRSEQ_EVT_GPIO);
+}
+
+static struct gpio_snapshot_sub pwrseq_gpio_sub = {
+	.handler = pwrseq_gpio_handler,
+};
+
+static void pwrseq_espi_handler(enum espihub_pwrseq_evt evt, uint8_t signal,
+				uint8_t level)
+{
+	switch (evt) {
+	case ESPIHUB_PWRSEQ_EVT_VWIRE:
+		pwrseq_trace_vwire_edge(signal, level);
+		/* Power sequencing may be waiting on any virtual wire */
+		pwrseq_evt_post(PWRSEQ_EVT_VWIRE);
+		break;
+	case ESPIHUB_PWRSEQ_EVT_ESPI_RST:
+		pwrseq_evt_post(PWRSEQ_EVT_ESPI_RST);
+		break;
+	default:
+		break;
+	}
+}
+
+static const struct espihub_pwrseq_hooks pwrseq_espi_hooks = {
+	.event = pwrseq_espi_handler,
+	.wait = pwrseq_wait_cond,
+};
+
+void pwrseq_events_init(void)
+{
+	const uint32_t pins[] = {
+		RSMRST_PWRGD,
+		ALL_SYS_PWRGD,
+		PM_SLP_SUS,
+		BC_ACOK,
+#ifdef PWR_OK
+		PWR_OK,
+#endif
+	};
+	int ret;
+
+	espihub_set_pwrseq_hooks(&pwrseq_espi_hooks);
+
+	for (int i = 0; i < ARRAY_SIZE(pins); i++) {
+		/* Pin is still periodically re-evaluated */
+		ret = gpio_snapshot_add_pin(pins[i], 0);
+		if (ret) {
+			LOG_WRN("Failed to monitor %x: %d",
+				gpio_get_pin(pins[i]), ret);
+			continue;
+		}
+
+		pwrseq_gpio_sub.mask |= gpio_snapshot_pin_mask(pins[i]);
+	}
+
+	gpio_snapshot_subscribe(&pwrseq_gpio_sub);
+}
+
+void pwrseq_evt_post(uint32_t evt)
+{
+	ec_task_post(&pwrseq_task, evt);
+}
+
+uint32_t pwrseq_evt_wait(k_timeout_t timeout)
+{
+	return ec_task_wait_timeout(&pwrseq_task, timeout) & EC_TASK_EVT_MASK;
+}
+
+uint32_t pwrseq_evt_wait_period(uint32_t period_ms)
+{
+	pwrseq_task.slack_ms = period_ms / 4U;
+	ec_task_set_period(&pwrseq_task, period_ms);
+
+	return ec_task_wait(&pwrseq_task) & EC_TASK_EVT_MASK;
+}
+
+int pwrseq_wait_cond(pwrseq_cond_t cond, void *arg, uint16_t timeout)
+{
+	bool forever = (timeout == WAIT_TIMEOUT_FOREVER);
+	int64_t deadline = k_uptime_ticks() +
+			   k_us_to_ticks_ceil64(timeout * 100ULL);
+	k_ticks_t wait = k_ms_to_ticks_ceil64(CONFIG_POWER_SEQUENCE_RECHECK_MS);
+	int64_t remaining;
+	int ret;
+
+	while (true) {
+		ret = cond(arg);
+		if (ret) {
+			return (ret > 0) ? 0 : ret;
+		}
+
+		remaining = deadline - k_uptime_ticks();
+		if (!forever && !ec_timeout_status()) {
+			if (remaining <= 0) {
+				return -ETIMEDOUT;
+			}
+
+			pwrseq_evt_wait(K_TICKS(MIN(remaining, wait)));
+		} else {
+			pwrseq_evt_wait(K_TICKS(wait));
+		}
+	}
+}
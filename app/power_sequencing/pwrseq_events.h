@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __PWRSEQ_EVENTS_H__
+#define __PWRSEQ_EVENTS_H__
+
+#include <zephyr.h>
+
+/**
+ * @brief Power sequencing events.
+ *
+ * Events only indicate that some power sequencing input may have changed,
+ * waiters always re-evaluate the signals they depend on.
+ */
+#define PWRSEQ_EVT_GPIO		BIT(0)
+#define PWRSEQ_EVT_VWIRE	BIT(1)
+#define PWRSEQ_EVT_ESPI_RST	BIT(2)
+#define PWRSEQ_EVT_REQUEST	BIT(3)
+
+/**
+ * @brief Condition evaluated by pwrseq_wait_cond().
+ *
+ * @param arg condition specific data.
+ *
+ * @retval 1 if condition is met, 0 if not yet, negative errno to abort.
+ */
+typedef int (*pwrseq_cond_t)(void *arg);
+
+/**
+ * @brief Monitor power sequencing inputs.
+ *
+ * GPIOs are monitored through GPIO snapshots and eSPI inputs through eSPI
+ * hub hooks. Must be called once boot mode is known, since some pins depend
+ * on it, and before any eSPI hub wait.
+ */
+void pwrseq_events_init(void);
+
+/**
+ * @brief Notify power sequencing that one of its inputs changed.
+ *
+ * @param evt PWRSEQ_EVT_* bitmask.
+ *
+ * @note Can be called from ISR.
+ */
+void pwrseq_evt_post(uint32_t evt);
+
+/**
+ * @brief Wait for any power sequencing event.
+ *
+ * @param timeout maximum time to wait.
+ *
+ * @retval PWRSEQ_EVT_* bitmask of events posted since previous call, 0 on
+ * timeout.
+ */
+uint32_t pwrseq_evt_wait(k_timeout_t timeout);
+
+/**
+ * @brief Wait for any power sequencing event or the next input sampling.
+ *
+ * Unlike pwrseq_evt_wait(), periodic sampling keeps its own schedule and may
+ * be delayed by up to a quarter of a period to share a wakeup with other EC
+ * tasks.
+ *
+ * @param period_ms input sampling period.
+ *
+ * @retval PWRSEQ_EVT_* bitmask of events posted since previous call, 0 if
+ * woken up for sampling.
+ */
+uint32_t pwrseq_evt_wait_period(uint32_t period_ms);
+
+/**
+ * @brief Wait until a condition is met or a deadline expires.
+ *
+ * Condition is evaluated on every power sequencing event and at least every
+ * CONFIG_POWER_SEQUENCE_RECHECK_MS for inputs without event source.
+ *
+ * @param cond condition to evaluate.
+ * @param arg data passed to the condition.
+ * @param timeout value expressed in multiple of 100us, WAIT_TIMEOUT_FOREVER
+ * to wait indefinitely. Ignored when EC timeouts are disabled.
+ *
+ * @retval 0 if condition met, -ETIMEDOUT or negative errno from condition.
+ *
+ * @note Only the power sequencing thread waits for events.
+ */
+int pwrseq_wait_cond(pwrseq_cond_t cond, void *arg, uint16_t timeout);
+
+#endif /* __PWRSEQ_EVENTS_H__ */
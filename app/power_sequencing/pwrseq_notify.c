@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <logging/log.h>
+#include "system.h"
+#include "pwrplane.h"
+#include "deepsx.h"
+#include "smchost.h"
+#include "pwrseq_notify.h"
+
+LOG_MODULE_DECLARE(pwrmgmt, CONFIG_PWRMGT_LOG_LEVEL);
+
+static sys_slist_t notifiers;
+static K_MUTEX_DEFINE(notify_lock);
+static enum pwrseq_pstate cur_pstate = PWRSEQ_PSTATE_G3;
+
+static enum pwrseq_pstate pwrseq_pstate_eval(void)
+{
+	switch (pwrseq_system_state()) {
+	case SYSTEM_S0_STATE:
+		return smchost_is_system_in_cs() ? PWRSEQ_PSTATE_S0IX :
+						   PWRSEQ_PSTATE_S0;
+	case SYSTEM_S3_STATE:
+		return dsx_entered() ? PWRSEQ_PSTATE_DEEPSX :
+				       PWRSEQ_PSTATE_S3;
+	case SYSTEM_S4_STATE:
+		return dsx_entered() ? PWRSEQ_PSTATE_DEEPSX :
+				       PWRSEQ_PSTATE_S4;
+	case SYSTEM_S5_STATE:
+		return dsx_entered() ? PWRSEQ_PSTATE_DEEPSX :
+				       PWRSEQ_PSTATE_S5;
+	case SYSTEM_G3_STATE:
+	default:
+		return PWRSEQ_PSTATE_G3;
+	}
+}
+
+void pwrseq_notify_register(struct pwrseq_notifier *notifier)
+{
+	struct pwrseq_notifier *n;
+	struct pwrseq_notifier *prev = NULL;
+
+	k_mutex_lock(&notify_lock, K_FOREVER);
+
+	/* Keep list sorted by priority, same priority in registration order */
+	SYS_SLIST_FOR_EACH_CONTAINER(&notifiers, n, node) {
+		if (n->priority > notifier->priority) {
+			break;
+		}
+		prev = n;
+	}
+
+	if (prev) {
+		sys_slist_insert(&notifiers, &prev->node, &notifier->node);
+	} else {
+		sys_slist_prepend(&notifiers, &notifier->node);
+	}
+
+	k_mutex_unlock(&notify_lock);
+}
+
+enum pwrseq_pstate pwrseq_notify_state(void)
+{
+	return cur_pstate;
+}
+
+void pwrseq_notify_update(void)
+{
+	struct pwrseq_notifier *n;
+	enum pwrseq_pstate prev;
+	enum pwrseq_pstate next;
+
+	k_mutex_lock(&notify_lock, K_FOREVER);
+
+	prev = cur_pstate;
+	next = pwrseq_pstate_eval();
+	if (next == prev) {
+		k_mutex_unlock(&notify_lock);
+		return;
+	}
+
+	LOG_DBG("Power state %d->%d", prev, next);
+	cur_pstate = next;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&notifiers, n, node) {
+		if (n->exit && (n->states & PWRSEQ_PSTATE_MASK(prev))) {
+			n->exit(prev, next);
+		}
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&notifiers, n, node) {
+		if (n->entry && (n->states & PWRSEQ_PSTATE_MASK(next))) {
+			n->entry(next, prev);
+		}
+	}
+
+	k_mutex_unlock(&notify_lock);
+}
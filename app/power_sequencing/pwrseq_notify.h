@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __PWRSEQ_NOTIFY_H__
+#define __PWRSEQ_NOTIFY_H__
+
+#include <zephyr.h>
+#include <sys/slist.h>
+
+/**
+ * @brief Platform power states reported to EC modules.
+ *
+ * Refines system power state with connected standby and deep Sx.
+ */
+enum pwrseq_pstate {
+	PWRSEQ_PSTATE_G3,
+	PWRSEQ_PSTATE_S0,
+	/* S0 connected standby */
+	PWRSEQ_PSTATE_S0IX,
+	PWRSEQ_PSTATE_S3,
+	PWRSEQ_PSTATE_S4,
+	PWRSEQ_PSTATE_S5,
+	PWRSEQ_PSTATE_DEEPSX,
+};
+
+#define PWRSEQ_PSTATE_MASK(state)	BIT(state)
+
+/* Any state the host is not running in */
+#define PWRSEQ_PSTATE_SX_MASK	(PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_G3) | \
+				 PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_S3) | \
+				 PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_S4) | \
+				 PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_S5) | \
+				 PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_DEEPSX))
+
+#define PWRSEQ_PSTATE_ALL_MASK	GENMASK(PWRSEQ_PSTATE_DEEPSX, 0)
+
+/**
+ * @brief Power state change subscriber.
+ *
+ * Callbacks run in the context of the thread completing the transition,
+ * typically power sequencing or SMC host, and must not block. Modules are
+ * expected to only signal their own thread from them.
+ */
+struct pwrseq_notifier {
+	sys_snode_t node;
+	/* Lower values are notified first */
+	uint8_t priority;
+	/* PWRSEQ_PSTATE_MASK() of the states of interest */
+	uint32_t states;
+	/* Optional, called once a state of interest is entered */
+	void (*entry)(enum pwrseq_pstate state, enum pwrseq_pstate prev);
+	/* Optional, called when leaving a state of interest */
+	void (*exit)(enum pwrseq_pstate state, enum pwrseq_pstate next);
+};
+
+/**
+ * @brief Register for power state change notifications.
+ *
+ * Entry callback is not invoked for the state in effect at registration,
+ * use pwrseq_notify_state() to get it.
+ *
+ * @param notifier subscriber, must remain valid while registered.
+ */
+void pwrseq_notify_register(struct pwrseq_notifier *notifier);
+
+/**
+ * @brief Get current platform power state.
+ *
+ * @retval last power state notified.
+ */
+enum pwrseq_pstate pwrseq_notify_state(void);
+
+/**
+ * @brief Check if host is running, including connected standby.
+ *
+ * @retval true if last power state notified is S0 or S0ix.
+ */
+static inline bool pwrseq_notify_host_in_s0(void)
+{
+	enum pwrseq_pstate state = pwrseq_notify_state();
+
+	return (state == PWRSEQ_PSTATE_S0) || (state == PWRSEQ_PSTATE_S0IX);
+}
+
+/**
+ * @brief Re-evaluate platform power state and notify any change.
+ *
+ * Called by the modules owning power state information, i.e. power
+ * sequencing, deep Sx and SMC host connected standby handling.
+ */
+void pwrseq_notify_update(void);
+
+#endif /* __PWRSEQ_NOTIFY_H__ */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <logging/log.h>
+#include <drivers/espi.h>
+#include "emi.h"
+#include "pwrseq_trace.h"
+
+LOG_MODULE_DECLARE(pwrmgmt, CONFIG_PWRMGT_LOG_LEVEL);
+
+#define TRACE_SEQS		CONFIG_PWRSEQ_TRACE_SEQUENCES
+#define TRACE_STEPS		CONFIG_PWRSEQ_TRACE_STEPS
+
+/* Host edges kept while no sequence runs, attached to the next sequence if
+ * it starts within the window.
+ */
+#define TRACE_EDGES_PENDING	4
+#define TRACE_EDGE_WINDOW_MS	1000
+
+BUILD_ASSERT(TRACE_SEQS <= UINT8_MAX, "Too many traced sequences");
+BUILD_ASSERT(TRACE_STEPS <= UINT8_MAX, "Too many steps per sequence");
+
+struct __packed pwrseq_trace_rec {
+	uint8_t src;
+	uint8_t id;
+	uint8_t gpio;
+	/* 0 if signal reached expected level, errno otherwise */
+	uint8_t status;
+	/* Relative to sequence start */
+	uint32_t start_us;
+	uint32_t dur_us;
+};
+
+struct __packed pwrseq_trace_seq {
+	uint8_t type;
+	uint8_t steps;
+	uint8_t seq_num;
+	uint8_t error;
+	uint32_t start_ms;
+	/* 0 while sequence is in progress */
+	uint32_t dur_us;
+	struct pwrseq_trace_rec step[TRACE_STEPS];
+};
+
+struct __packed pwrseq_trace_log {
+	uint16_t magic;
+	uint8_t version;
+	uint8_t seq_count;
+	uint8_t step_count;
+	uint8_t last;
+	uint8_t rsvd[2];
+	struct pwrseq_trace_seq seq[TRACE_SEQS];
+};
+
+BUILD_ASSERT(sizeof(struct pwrseq_trace_log) + sizeof(emi_dir_t) <=
+	     CONFIG_EMI_ARENA_SIZE, "Power sequence trace exceeds EMI arena");
+
+/* Allocated in EMI arena, exposed as is to the host */
+static struct pwrseq_trace_log *trace_log;
+static emi_block_t trace_blk;
+
+struct pwrseq_trace_edge {
+	uint8_t src;
+	uint8_t signal;
+	int64_t ticks;
+};
+
+/* Sequences are traced from power sequencing thread, host edges are
+ * recorded from eSPI ISR.
+ */
+static struct k_spinlock trace_lock;
+static struct pwrseq_trace_seq *cur_seq;
+static int64_t cur_seq_start;
+static uint8_t seq_num;
+static struct pwrseq_trace_edge edges[TRACE_EDGES_PENDING];
+static uint8_t edge_cnt;
+
+static inline uint32_t ticks_to_us(int64_t ticks)
+{
+	return (uint32_t)k_ticks_to_us_floor64(ticks);
+}
+
+void pwrseq_trace_init(void)
+{
+	if (emi_block_publish(&trace_blk, EMI_BLOCK_PWRSEQ_TRACE,
+			      PWRSEQ_TRACE_VERSION,
+			      sizeof(*trace_log)) != EMI_SUCCESS) {
+		LOG_WRN("Power sequence trace not exposed over EMI");
+		return;
+	}
+
+	trace_log = trace_blk.data;
+	trace_log->magic = PWRSEQ_TRACE_MAGIC;
+	trace_log->version = PWRSEQ_TRACE_VERSION;
+	trace_log->seq_count = TRACE_SEQS;
+	trace_log->step_count = TRACE_STEPS;
+	trace_log->last = TRACE_SEQS - 1;
+	emi_block_update_end(&trace_blk);
+}
+
+/* Must be called with trace_lock held */
+static void trace_add_step(uint8_t src, uint8_t id, uint8_t gpio,
+			   int64_t start, int64_t end, int ret)
+{
+	struct pwrseq_trace_rec *rec;
+
+	/* Waits outside traced sequences, e.g. deep Sx, are not recorded */
+	if (cur_seq == NULL || cur_seq->steps >= TRACE_STEPS) {
+		return;
+	}
+
+	rec = &cur_seq->step[cur_seq->steps];
+	rec->src = src;
+	rec->id = id;
+	rec->gpio = gpio;
+	rec->status = MIN(-ret, UINT8_MAX);
+	rec->start_us = ticks_to_us(start - cur_seq_start);
+	rec->dur_us = ticks_to_us(end - start);
+	cur_seq->steps++;
+}
+
+void pwrseq_trace_begin(enum pwrseq_trace_type type)
+{
+	int64_t now = k_uptime_ticks();
+	int64_t window = k_ms_to_ticks_ceil64(TRACE_EDGE_WINDOW_MS);
+	k_spinlock_key_t key;
+	uint8_t first = 0;
+
+	if (trace_log == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&trace_lock);
+
+	/* Older edges did not trigger this sequence */
+	while (first < edge_cnt && now - edges[first].ticks > window) {
+		first++;
+	}
+
+	/* Steps are appended while sequence runs, generation only changes
+	 * when a slot is recycled or a sequence completes.
+	 */
+	emi_block_update_begin(&trace_blk);
+	trace_log->last = (trace_log->last + 1) % TRACE_SEQS;
+	cur_seq = &trace_log->seq[trace_log->last];
+	cur_seq_start = (first < edge_cnt) ? edges[first].ticks : now;
+
+	memset(cur_seq, 0, sizeof(*cur_seq));
+	cur_seq->seq_num = seq_num++;
+	cur_seq->start_ms = k_ticks_to_ms_floor32(cur_seq_start);
+	for (; first < edge_cnt; first++) {
+		trace_add_step(edges[first].src, edges[first].signal,
+			       UINT8_MAX, edges[first].ticks,
+			       edges[first].ticks, 0);
+	}
+	edge_cnt = 0;
+
+	/* Written last, host ignores slots without type */
+	cur_seq->type = type;
+	emi_block_update_end(&trace_blk);
+
+	k_spin_unlock(&trace_lock, key);
+}
+
+void pwrseq_trace_step(enum pwrseq_trace_src src, uint8_t id, uint8_t gpio,
+		       int64_t start, int ret)
+{
+	k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+	trace_add_step(src, id, gpio, start, k_uptime_ticks(), ret);
+	k_spin_unlock(&trace_lock, key);
+}
+
+void pwrseq_trace_vwire_edge(uint8_t signal, uint8_t level)
+{
+	uint8_t src = level ? PWRSEQ_TRACE_SRC_VWIRE_HIGH :
+			      PWRSEQ_TRACE_SRC_VWIRE_LOW;
+	int64_t now = k_uptime_ticks();
+	k_spinlock_key_t key;
+
+	switch (signal) {
+	case ESPI_VWIRE_SIGNAL_PLTRST:
+	case ESPI_VWIRE_SIGNAL_SLP_S3:
+	case ESPI_VWIRE_SIGNAL_SLP_S4:
+	case ESPI_VWIRE_SIGNAL_SLP_S5:
+		break;
+	default:
+		return;
+	}
+
+	key = k_spin_lock(&trace_lock);
+	if (cur_seq) {
+		trace_add_step(src, signal, UINT8_MAX, now, now, 0);
+	} else if (trace_log) {
+		/* Keep most recent edges */
+		if (edge_cnt == TRACE_EDGES_PENDING) {
+			memmove(&edges[0], &edges[1],
+				sizeof(edges[0]) * (TRACE_EDGES_PENDING - 1));
+			edge_cnt--;
+		}
+
+		edges[edge_cnt].src = src;
+		edges[edge_cnt].signal = signal;
+		edges[edge_cnt].ticks = now;
+		edge_cnt++;
+	}
+	k_spin_unlock(&trace_lock, key);
+}
+
+void pwrseq_trace_error(uint8_t error_code)
+{
+	k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+	if (cur_seq) {
+		cur_seq->error = error_code;
+	}
+	k_spin_unlock(&trace_lock, key);
+}
+
+void pwrseq_trace_end(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&trace_lock);
+	struct pwrseq_trace_seq *seq = cur_seq;
+
+	if (seq == NULL) {
+		k_spin_unlock(&trace_lock, key);
+		return;
+	}
+
+	/* Never 0 for a completed sequence */
+	emi_block_update_begin(&trace_blk);
+	seq->dur_us = MAX(ticks_to_us(k_uptime_ticks() - cur_seq_start), 1u);
+	emi_block_update_end(&trace_blk);
+	cur_seq = NULL;
+	k_spin_unlock(&trace_lock, key);
+
+	LOG_INF("Power sequence %d took %d us", seq->type, seq->dur_us);
+}
+
+void pwrseq_trace_read_chunk(uint16_t chunk, uint8_t *buf)
+{
+	const uint8_t *log = (const uint8_t *)trace_log;
+	uint32_t ofs = chunk * PWRSEQ_TRACE_CHUNK_SIZE;
+
+	for (uint8_t i = 0; i < PWRSEQ_TRACE_CHUNK_SIZE; i++, ofs++) {
+		buf[i] = (log && ofs < sizeof(*trace_log)) ? log[ofs] : 0xFF;
+	}
+}
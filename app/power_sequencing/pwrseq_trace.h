@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __PWRSEQ_TRACE_H__
+#define __PWRSEQ_TRACE_H__
+
+#include <zephyr.h>
+
+/* Trace log is exported as raw memory, keep in sync with the decoder in
+ * tools/pwrseq_trace.
+ */
+#define PWRSEQ_TRACE_MAGIC		0x5350
+#define PWRSEQ_TRACE_VERSION		1u
+
+/* Host reads the log in chunks of this size via SMC */
+#define PWRSEQ_TRACE_CHUNK_SIZE		8u
+
+/**
+ * @brief Power sequences being traced.
+ */
+enum pwrseq_trace_type {
+	PWRSEQ_TRACE_NONE,
+	PWRSEQ_TRACE_INIT,
+	PWRSEQ_TRACE_BOOT,
+	PWRSEQ_TRACE_RESUME,
+	PWRSEQ_TRACE_SUSPEND,
+	PWRSEQ_TRACE_SHUTDOWN,
+};
+
+/**
+ * @brief Kind of signal waited on by a trace step.
+ */
+enum pwrseq_trace_src {
+	PWRSEQ_TRACE_SRC_GPIO,
+	PWRSEQ_TRACE_SRC_VWIRE,
+	PWRSEQ_TRACE_SRC_ESPI_RST,
+	/* Virtual wire edges received from host, not waits */
+	PWRSEQ_TRACE_SRC_VWIRE_LOW,
+	PWRSEQ_TRACE_SRC_VWIRE_HIGH,
+};
+
+/**
+ * @brief Power sequencing GPIOs identifiers, board independent.
+ */
+enum pwrseq_trace_pin {
+	PWRSEQ_TRACE_PIN_OTHER,
+	PWRSEQ_TRACE_PIN_RSMRST_PWRGD,
+	PWRSEQ_TRACE_PIN_ESPI_RESET,
+	PWRSEQ_TRACE_PIN_ALL_SYS_PWRGD,
+	PWRSEQ_TRACE_PIN_PWR_OK,
+	PWRSEQ_TRACE_PIN_PWRBTN,
+	PWRSEQ_TRACE_PIN_SLP_SUS,
+};
+
+#ifdef CONFIG_PWRSEQ_TRACE
+
+/**
+ * @brief Initialize trace log and expose it over EMI.
+ */
+void pwrseq_trace_init(void);
+
+/**
+ * @brief Start tracing a new power sequence.
+ *
+ * Oldest sequence is overwritten once all trace slots are used.
+ *
+ * @param type sequence type.
+ */
+void pwrseq_trace_begin(enum pwrseq_trace_type type);
+
+/**
+ * @brief Record a wait for a signal in the current sequence.
+ *
+ * @param src kind of signal.
+ * @param id signal identifier, enum pwrseq_trace_pin for GPIOs or eSPI
+ *	     virtual wire signal.
+ * @param gpio absolute GPIO number, 0xFF if not applicable.
+ * @param start uptime in ticks when the wait started.
+ * @param ret wait result, 0 or negative errno.
+ */
+void pwrseq_trace_step(enum pwrseq_trace_src src, uint8_t id, uint8_t gpio,
+		       int64_t start, int ret);
+
+/**
+ * @brief Record a virtual wire edge received from host.
+ *
+ * Only PLTRST# and SLP_S3/4/5# edges are recorded. Edges received shortly
+ * before a sequence starts are recorded in it, so the sequence covers the
+ * host request that triggered it.
+ *
+ * @param signal eSPI virtual wire signal.
+ * @param level new virtual wire level.
+ *
+ * @note Can be called from ISR.
+ */
+void pwrseq_trace_vwire_edge(uint8_t signal, uint8_t level);
+
+/**
+ * @brief Record power sequencing error code in the current sequence.
+ *
+ * @param error_code power sequencing error.
+ */
+void pwrseq_trace_error(uint8_t error_code);
+
+/**
+ * @brief Complete current sequence.
+ */
+void pwrseq_trace_end(void);
+
+/**
+ * @brief Read a chunk of the trace log.
+ *
+ * @param chunk chunk index.
+ * @param buf buffer of PWRSEQ_TRACE_CHUNK_SIZE bytes, bytes past the end of
+ *	      the log are returned as 0xFF.
+ */
+void pwrseq_trace_read_chunk(uint16_t chunk, uint8_t *buf);
+
+#else
+
+static inline void pwrseq_trace_init(void) {}
+static inline void pwrseq_trace_begin(enum pwrseq_trace_type type) {}
+static inline void pwrseq_trace_step(enum pwrseq_trace_src src, uint8_t id,
+				     uint8_t gpio, int64_t start, int ret) {}
+static inline void pwrseq_trace_vwire_edge(uint8_t signal, uint8_t level) {}
+static inline void pwrseq_trace_error(uint8_t error_code) {}
+static inline void pwrseq_trace_end(void) {}
+
+#endif /* CONFIG_PWRSEQ_TRACE */
+
+#endif /* __PWRSEQ_TRACE_H__ */
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <zephyr.h>
 #include <device.h>
 #include <soc.h>
@@ -11,15 +12,21 @@
 #include <drivers/espi.h>
 #include <drivers/espi_saf.h>
 #include <logging/log.h>
+#include <sys/byteorder.h>
 #include "board_config.h"
 #include "saf_spi_transaction.h"
 #include "saf_config.h"
+#include "saf_spi_parts.h"
 
 LOG_MODULE_REGISTER(saf_config, CONFIG_ESPIHUB_LOG_LEVEL);
 
 #define SPI_RESET_DELAY_US             40U
 #define MHZ_TO_HZ(x)                   ((x) * 1000000U)
 #define MAX_SPI_RESPONSE               10U
+/* Worst case 64KB block erase */
+#define SPI_RESUME_TIMEOUT_MS          2000U
+#define SFDP_SIGNATURE                 0x50444653U
+#define SFDP_BFPT_ID                   0xFF00U
 
 /* SPI opcodes are vendor-specific.
  * These are either used directly as commands sent via SPI driver
@@ -65,12 +72,74 @@ static struct saf_spi_transaction *spi_cmd(enum saf_command_index command)
 #endif
 }
 
+/* Skip step if device already reported quad enable */
+#define SEQ_SKIP_IF_QE		BIT(0)
+
+struct spi_seq_step {
+	enum saf_command_index cmd;
+	uint8_t flags;
+};
+
+/* Per device SPI configurations are built once, so consecutive commands
+ * with the same lines mode are not reconfiguring the controller.
+ */
+enum spi_cfg_mode {
+	SPI_CFG_SINGLE,
+	SPI_CFG_IO,
+	SPI_CFG_COUNT,
+};
+
+struct spi_flash_dev {
+	struct spi_config cfg[SPI_CFG_COUNT];
+	/* Last status register 2 read */
+	uint8_t sts2;
+	bool sts2_valid;
+	const struct saf_spi_part *part;
+	/* Part was not assumed from build configuration */
+	bool identified;
+	/* Unknown part described by SFDP */
+	struct saf_spi_part sfdp_part;
+};
+
 static const struct device *saf_dev;
 static const struct device *spi_dev;
-static struct spi_config spi_cfg;
+static struct spi_flash_dev flash_devs[CONFIG_SAF_SPI_DEVICES_COUNT];
 
-static int spi_send_cmd(uint8_t slave_index, struct saf_spi_transaction *cmd,
-			int mode)
+static struct spi_config *spi_dev_cfg(uint8_t slave_index, int mode)
+{
+	return &flash_devs[slave_index].cfg[mode == SPI_LINES_SINGLE ?
+					    SPI_CFG_SINGLE : SPI_CFG_IO];
+}
+
+static void spi_dev_set_freq(uint8_t slave_index, uint32_t freq_mhz)
+{
+	struct spi_flash_dev *dev = &flash_devs[slave_index];
+
+	for (int i = 0; i < SPI_CFG_COUNT; i++) {
+		dev->cfg[i].frequency = MHZ_TO_HZ(freq_mhz);
+	}
+}
+
+static void spi_dev_cfg_init(uint8_t slave_index)
+{
+	struct spi_flash_dev *dev = &flash_devs[slave_index];
+
+	for (int i = 0; i < SPI_CFG_COUNT; i++) {
+		dev->cfg[i].frequency = MHZ_TO_HZ(CONFIG_SAF_SPI_FREQ_MHZ);
+		dev->cfg[i].operation = SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB |
+					SPI_WORD_SET(8) |
+					(i == SPI_CFG_SINGLE ?
+					 SPI_LINES_SINGLE : SPI_IO_LINES);
+		dev->cfg[i].slave = slave_index;
+		dev->cfg[i].cs = NULL;
+	}
+
+	dev->sts2_valid = false;
+}
+
+static int spi_send_cmd_resp(uint8_t slave_index,
+			     struct saf_spi_transaction *cmd, int mode,
+			     uint8_t *resp)
 {
 	int ret;
 	uint8_t data[MAX_SPI_RESPONSE];
@@ -99,49 +168,263 @@ static int spi_send_cmd(uint8_t slave_index, struct saf_spi_transaction *cmd,
 		rx_bufs.count = 1;
 	}
 
-	spi_cfg.operation = SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB
-			    | SPI_WORD_SET(8) | mode;
-	spi_cfg.slave = slave_index;
-
-	ret = spi_transceive(spi_dev, &spi_cfg, &tx_bufs, &rx_bufs);
+	ret = spi_transceive(spi_dev, spi_dev_cfg(slave_index, mode), &tx_bufs,
+			     &rx_bufs);
 	if (ret < 0) {
 		LOG_ERR("SPI transceive error: %d", ret);
 		return ret;
 	}
 
+	if (resp) {
+		memcpy(resp, data, cmd->rx_len);
+	}
+
 	return 0;
 }
 
-static int qspi_read_status(uint8_t slave_index)
+static int spi_send_cmd(uint8_t slave_index, struct saf_spi_transaction *cmd,
+			int mode)
 {
-	int ret;
-	struct saf_spi_transaction *spi_command;
+	return spi_send_cmd_resp(slave_index, cmd, mode, NULL);
+}
 
-	LOG_DBG("%s ", __func__);
+/* Single line command using a part specific opcode */
+static int spi_send_opcode(uint8_t slave_index, uint8_t opcode,
+			   const uint8_t *data, uint8_t tx_len, uint8_t rx_len,
+			   uint8_t *resp)
+{
+	struct saf_spi_transaction cmd = {
+		.buf = { opcode },
+		.tx_len = 1 + tx_len,
+		.rx_len = rx_len,
+		.mode = SPI_LINES_SINGLE,
+	};
+
+	if (data) {
+		memcpy(&cmd.buf[1], data, tx_len);
+	}
+
+	return spi_send_cmd_resp(slave_index, &cmd, SPI_LINES_SINGLE, resp);
+}
 
-	enum saf_command_index cmds[] = {
-		RD_STS1_CMD_INDEX, RD_STS2_CMD_INDEX, EN_RST_CMD_INDEX,
-		RD_STS1_CMD_INDEX, RD_STS1_CMD_INDEX
+/* Read up to 8 bytes of SFDP, opcode and address are followed by a dummy
+ * byte that the driver sends as buffer is shorter than tx_len.
+ */
+static int spi_read_sfdp(uint8_t slave_index, uint32_t addr, uint8_t *resp,
+			 uint8_t len)
+{
+	struct saf_spi_transaction cmd = {
+		.buf = { READ_SFDP_OPCODE, addr >> 16, addr >> 8, addr },
+		.tx_len = 5,
+		.rx_len = len,
+		.mode = SPI_LINES_SINGLE,
 	};
 
+	return spi_send_cmd_resp(slave_index, &cmd, SPI_LINES_SINGLE, resp);
+}
 
-	for (int i = 0; i < ARRAY_SIZE(cmds); i++) {
-		spi_command = spi_cmd(cmds[i]);
-		if (spi_command != NULL) {
-			ret = spi_send_cmd(slave_index, spi_command,
-					 SPI_LINES_SINGLE);
-			if (ret) {
-				return ret;
-			}
-		} else {
+static int spi_flash_read_bfpt(uint8_t slave_index, uint32_t *bfpt)
+{
+	uint8_t resp[MAX_SPI_RESPONSE];
+	uint32_t ptr;
+	int ret;
+
+	ret = spi_read_sfdp(slave_index, 0, resp, 8);
+	if (ret) {
+		return ret;
+	}
+
+	if (sys_get_le32(resp) != SFDP_SIGNATURE) {
+		return -ENOTSUP;
+	}
+
+	/* First parameter header is always the basic flash parameter table */
+	ret = spi_read_sfdp(slave_index, 8, resp, 8);
+	if (ret) {
+		return ret;
+	}
+
+	if ((resp[0] | (resp[7] << 8)) != SFDP_BFPT_ID ||
+	    resp[3] < SAF_SFDP_BFPT_DWORDS) {
+		return -ENOTSUP;
+	}
+
+	ptr = sys_get_le24(&resp[4]);
+	for (int i = 0; i < SAF_SFDP_BFPT_DWORDS; i += 2) {
+		ret = spi_read_sfdp(slave_index, ptr + i * 4U, resp, 8);
+		if (ret) {
+			return ret;
+		}
+
+		bfpt[i] = sys_get_le32(resp);
+		bfpt[i + 1] = sys_get_le32(&resp[4]);
+	}
+
+	return 0;
+}
+
+/* Identify part by JEDEC ID, parts not in database are described by SFDP.
+ * Parts not usable with SAF descriptors fall back to the default part.
+ */
+static void spi_flash_detect(uint8_t slave_index)
+{
+	struct spi_flash_dev *dev = &flash_devs[slave_index];
+	uint32_t bfpt[SAF_SFDP_BFPT_DWORDS];
+	uint8_t resp[MAX_SPI_RESPONSE];
+	uint32_t jedec_id;
+	int ret;
+
+	dev->part = NULL;
+	dev->identified = false;
+
+	ret = spi_send_cmd_resp(slave_index, spi_cmd(RD_JEDEC_ID_CMD_INDEX),
+				SPI_LINES_SINGLE, resp);
+	if (ret) {
+		goto fallback;
+	}
+
+	jedec_id = sys_get_be24(resp);
+	if (jedec_id == 0 || jedec_id == 0xFFFFFF) {
+		LOG_WRN("SPI device %d no JEDEC ID", slave_index);
+		goto fallback;
+	}
+
+	dev->part = saf_spi_part_find(jedec_id);
+	if (!dev->part) {
+		ret = spi_flash_read_bfpt(slave_index, bfpt);
+		if (!ret) {
+			ret = saf_spi_part_from_sfdp(jedec_id, bfpt,
+						     &dev->sfdp_part);
+		}
+
+		if (ret) {
+			LOG_WRN("SPI device %d unknown part %06x", slave_index,
+				jedec_id);
+			goto fallback;
+		}
+
+		dev->part = &dev->sfdp_part;
+	}
+
+	if (!windbond_saf_part_supported(dev->part)) {
+		LOG_WRN("SPI device %d %s not supported by SAF config",
+			slave_index, dev->part->name);
+		dev->part = NULL;
+		goto fallback;
+	}
+
+	LOG_INF("SPI device %d %s (%06x) %d MB", slave_index, dev->part->name,
+		jedec_id, dev->part->capacity_mb);
+	dev->identified = true;
+
+	return;
+
+fallback:
+	dev->part = saf_spi_part_default();
+	LOG_WRN("SPI device %d assumed %s", slave_index, dev->part->name);
+}
+
+/* An erase or program suspended by SAF bridge is lost if the device is
+ * reset, e.g. EC reset while host was reading, leaving a partially erased
+ * sector. Resume it and wait for completion before resetting the device.
+ */
+static int qspi_resume_suspended(uint8_t slave_index)
+{
+	int ret;
+	uint8_t resp[MAX_SPI_RESPONSE];
+	int64_t deadline;
+
+	const struct saf_spi_opcodes *op = &flash_devs[slave_index].part->op;
+
+	ret = spi_send_opcode(slave_index, op->rd_sts2, NULL, 0, 1, resp);
+	if (ret) {
+		return ret;
+	}
+
+	/* QMSPI receives after opcode is sent, status is first byte */
+	if (!(resp[0] & STATUS_2_SUS_BIT)) {
+		return 0;
+	}
+
+	LOG_WRN("SPI device %d suspended, resuming", slave_index);
+	ret = spi_send_opcode(slave_index, op->resume, NULL, 0, 0, NULL);
+	if (ret) {
+		return ret;
+	}
+
+	deadline = k_uptime_get() + SPI_RESUME_TIMEOUT_MS;
+	do {
+		k_msleep(1);
+		ret = spi_send_opcode(slave_index, op->rd_sts1, NULL, 0, 1,
+				      resp);
+		if (ret) {
+			return ret;
+		}
+
+		if (!(resp[0] & STATUS_1_BUSY_BIT)) {
+			return 0;
+		}
+	} while (k_uptime_get() < deadline);
+
+	return -ETIMEDOUT;
+}
+
+/* Run a list of single line commands on a device, status register 2 value
+ * is kept to skip steps once device reports quad enable.
+ */
+static int spi_run_seq(uint8_t slave_index, const struct spi_seq_step *seq,
+		       size_t len)
+{
+	struct spi_flash_dev *dev = &flash_devs[slave_index];
+	struct saf_spi_transaction *spi_command;
+	uint8_t resp[MAX_SPI_RESPONSE];
+	int ret;
+
+	for (size_t i = 0; i < len; i++) {
+		if ((seq[i].flags & SEQ_SKIP_IF_QE) && dev->sts2_valid &&
+		    (dev->sts2 & STATUS_2_QE_BIT)) {
+			continue;
+		}
+
+		spi_command = spi_cmd(seq[i].cmd);
+		if (!spi_command) {
 			return -EINVAL;
 		}
 
+		ret = spi_send_cmd_resp(slave_index, spi_command,
+					SPI_LINES_SINGLE, resp);
+		if (ret) {
+			return ret;
+		}
+
+		/* QMSPI receives after opcode is sent, status is first byte */
+		if (seq[i].cmd == RD_STS2_CMD_INDEX) {
+			dev->sts2 = resp[0];
+			dev->sts2_valid = true;
+		}
 	}
 
 	return 0;
 }
 
+static int qspi_read_status(uint8_t slave_index)
+{
+	/* Trailing status reads only wait for a device that is not yet in
+	 * quad mode.
+	 */
+	static const struct spi_seq_step seq[] = {
+		{ RD_STS1_CMD_INDEX, 0 },
+		{ RD_STS2_CMD_INDEX, 0 },
+		{ EN_RST_CMD_INDEX, 0 },
+		{ RD_STS1_CMD_INDEX, SEQ_SKIP_IF_QE },
+		{ RD_STS1_CMD_INDEX, SEQ_SKIP_IF_QE },
+	};
+
+	LOG_DBG("%s ", __func__);
+
+	return spi_run_seq(slave_index, seq, ARRAY_SIZE(seq));
+}
+
 #ifdef CONFIG_SAF_ENABLE_XIP
 int qspi_enable_xip(uint8_t slave_index)
 {
@@ -194,7 +477,53 @@ static int qspi_reset_spi_flash_device(uint8_t slave_index)
 		}
 	}
 
-	k_busy_wait(SPI_RESET_DELAY_US);
+	return 0;
+}
+
+/* SAF quad IO reads need QE, set it in volatile status if device does not
+ * have it set in non-volatile status.
+ */
+static int qspi_enable_quad(uint8_t slave_index)
+{
+	const struct saf_spi_part *part = flash_devs[slave_index].part;
+	uint8_t resp[MAX_SPI_RESPONSE];
+	uint8_t sts2;
+	int ret;
+
+	ret = spi_send_opcode(slave_index, part->op.rd_sts2, NULL, 0, 1, resp);
+	if (ret) {
+		return ret;
+	}
+
+	if (resp[0] & part->qe_bit) {
+		return 0;
+	}
+
+	LOG_WRN("SPI device %d QE not set", slave_index);
+	sts2 = resp[0] | part->qe_bit;
+	ret = spi_send_opcode(slave_index, part->op.wr_en_volatile, NULL, 0, 0,
+			      NULL);
+	if (ret) {
+		return ret;
+	}
+
+	return spi_send_opcode(slave_index, part->op.wr_sts2, &sts2, 1, 0,
+			       NULL);
+}
+
+/* Device must have completed reset recovery */
+static int qspi_setup_spi_flash_device(uint8_t slave_index)
+{
+	int ret = 0;
+
+	LOG_DBG("%s", __func__);
+
+	if (SPI_IO_LINES == SPI_LINES_QUAD) {
+		ret = qspi_enable_quad(slave_index);
+		if (ret) {
+			return ret;
+		}
+	}
 
 #ifdef CONFIG_SAF_ENABLE_XIP
 	qspi_enable_xip(slave_index);
@@ -230,11 +559,8 @@ static int qspi_exit_continuous_mode(uint8_t slave_index)
 	tx.buf = NULL;
 	tx.len = 9;
 
-	spi_cfg.operation = SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB
-			    | SPI_WORD_SET(8) | SPI_IO_LINES;
-	spi_cfg.slave = slave_index;
-
-	ret = spi_transceive(spi_dev, &spi_cfg, &tx_bufs, &rx_bufs);
+	ret = spi_transceive(spi_dev, spi_dev_cfg(slave_index, SPI_IO_LINES),
+			     &tx_bufs, &rx_bufs);
 	if (ret < 0) {
 		LOG_ERR("SPI transceive error: %d", ret);
 		return ret;
@@ -243,23 +569,11 @@ static int qspi_exit_continuous_mode(uint8_t slave_index)
 	return 0;
 }
 
-int spi_flash_init(uint8_t slave_index)
+static int spi_flash_prepare(uint8_t slave_index)
 {
 	int ret;
 
-	LOG_DBG("%s", __func__);
-
-	spi_dev = device_get_binding(SPI_0);
-	if (!spi_dev) {
-		LOG_ERR("Failed to bind %s", SPI_0);
-		return -ENODEV;
-	};
-
-	spi_cfg.frequency = MHZ_TO_HZ(CONFIG_SAF_SPI_FREQ_MHZ);
-	spi_cfg.operation = SPI_OP_MODE_MASTER | SPI_TRANSFER_MSB
-			    | SPI_WORD_SET(8) | SPI_LINES_SINGLE;
-	spi_cfg.slave = 0;
-	spi_cfg.cs = NULL;
+	spi_dev_cfg_init(slave_index);
 
 	ret = qspi_read_status(slave_index);
 	if (ret) {
@@ -273,15 +587,83 @@ int spi_flash_init(uint8_t slave_index)
 		return ret;
 	}
 
-	ret = qspi_reset_spi_flash_device(slave_index);
+	spi_flash_detect(slave_index);
+	windbond_saf_set_part(slave_index, flash_devs[slave_index].part);
+
+	ret = qspi_resume_suspended(slave_index);
 	if (ret) {
-		LOG_ERR("Fail to reset SPI flash device: %d", ret);
+		LOG_ERR("Fail to resume SPI flash device: %d", ret);
 		return ret;
 	}
 
 	return 0;
 }
 
+/* All devices are brought to the point of reset first, so reset recovery
+ * time is waited once for all of them.
+ */
+static int spi_flash_init_all(void)
+{
+	uint32_t start = k_cycle_get_32();
+	uint32_t freq_mhz = CONFIG_SAF_SPI_MAX_FREQ_MHZ;
+	int ret;
+	int i;
+
+	LOG_DBG("%s", __func__);
+
+	spi_dev = device_get_binding(SPI_0);
+	if (!spi_dev) {
+		LOG_ERR("Failed to bind %s", SPI_0);
+		return -ENODEV;
+	};
+
+	for (i = 0; i < CONFIG_SAF_SPI_DEVICES_COUNT; i++) {
+		ret = spi_flash_prepare(i);
+		if (ret) {
+			goto err;
+		}
+
+		freq_mhz = MIN(freq_mhz, flash_devs[i].part->max_freq_mhz);
+		if (!flash_devs[i].identified) {
+			freq_mhz = MIN(freq_mhz, CONFIG_SAF_SPI_FREQ_MHZ);
+		}
+	}
+
+	/* Devices share the controller, use fastest clock all of them allow */
+	for (i = 0; i < CONFIG_SAF_SPI_DEVICES_COUNT; i++) {
+		spi_dev_set_freq(i, freq_mhz);
+	}
+
+	LOG_INF("SPI flash clock %d MHz", freq_mhz);
+
+	for (i = 0; i < CONFIG_SAF_SPI_DEVICES_COUNT; i++) {
+		ret = qspi_reset_spi_flash_device(i);
+		if (ret) {
+			LOG_ERR("Fail to reset SPI flash device: %d", ret);
+			goto err;
+		}
+	}
+
+	k_busy_wait(SPI_RESET_DELAY_US);
+
+	for (i = 0; i < CONFIG_SAF_SPI_DEVICES_COUNT; i++) {
+		ret = qspi_setup_spi_flash_device(i);
+		if (ret) {
+			LOG_ERR("Fail to setup SPI flash device: %d", ret);
+			goto err;
+		}
+	}
+
+	LOG_INF("SPI flash init %d us",
+		k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
+	return 0;
+
+err:
+	LOG_ERR("Fail to init SPI device %d: %d", i, ret);
+	return ret;
+}
+
 int initialize_saf_bridge(void)
 {
 	int ret;
@@ -298,12 +680,9 @@ int initialize_saf_bridge(void)
 	LOG_DBG("Frequency %d", CONFIG_SAF_SPI_FREQ_MHZ);
 
 	/* SAF requires that SPI flash device is reset and in Quad mode */
-	for (int i = 0; i < CONFIG_SAF_SPI_DEVICES_COUNT; i++) {
-		ret = spi_flash_init(i);
-		if (ret) {
-			LOG_ERR("Fail to init SPI device %d: %d", i, ret);
-			return ret;
-		}
+	ret = spi_flash_init_all();
+	if (ret) {
+		return ret;
 	}
 
 	ret = espi_saf_config(saf_dev, get_saf_cfg());
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include "saf_spi_parts.h"
+
+/* Opcodes shared by Winbond and GigaDevice, which also share the status
+ * register layout polled by SAF bridge: QE in status 2 bit 1, suspend
+ * status in status 2 bit 7.
+ */
+#define OPCODES_COMMON \
+	.rd_sts1 = 0x05U, \
+	.rd_sts2 = 0x35U, \
+	.wr_sts2 = 0x31U, \
+	.wr_en = 0x06U, \
+	.wr_en_volatile = 0x50U, \
+	.suspend = 0x75U, \
+	.resume = 0x7AU, \
+	.erase_32k = 0x52U
+
+#define OPCODES_3B { \
+	OPCODES_COMMON, \
+	.erase_4k = 0x20U, \
+	.erase_64k = 0xD8U, \
+	.program = 0x02U, \
+	.read_dual_io = 0xBBU, \
+	.read_quad_io = 0xEBU, \
+}
+
+#define OPCODES_4B { \
+	OPCODES_COMMON, \
+	.erase_4k = 0x21U, \
+	.erase_64k = 0xDCU, \
+	.program = 0x12U, \
+	.read_dual_io = 0xBCU, \
+	.read_quad_io = 0xECU, \
+}
+
+#define PART(_name, _id, _mb, _mhz, _op) { \
+	.name = _name, \
+	.jedec_id = _id, \
+	.capacity_mb = _mb, \
+	.max_freq_mhz = _mhz, \
+	.read_modes = SAF_PART_DUAL_IO | SAF_PART_QUAD_IO, \
+	.dual_dummy_clks = 4U, \
+	.quad_dummy_clks = 6U, \
+	.qe_bit = BIT(1), \
+	.erase_sizes = SAF_PART_ERASE_4K | SAF_PART_ERASE_32K | \
+		       SAF_PART_ERASE_64K, \
+	.op = _op, \
+}
+
+static const struct saf_spi_part parts[] = {
+	PART("W25Q128JV", 0xEF4018, 16, 133, OPCODES_3B),
+	PART("W25Q128JV-M", 0xEF7018, 16, 133, OPCODES_3B),
+	PART("W25Q128JW", 0xEF6018, 16, 133, OPCODES_3B),
+	PART("W25Q256JV", 0xEF4019, 32, 133, OPCODES_4B),
+	PART("W25Q256JV-M", 0xEF7019, 32, 133, OPCODES_4B),
+	PART("W25Q256JW", 0xEF6019, 32, 133, OPCODES_4B),
+	PART("GD25Q128E", 0xC84018, 16, 133, OPCODES_3B),
+	PART("GD25LQ128E", 0xC86018, 16, 133, OPCODES_3B),
+	PART("GD25Q256E", 0xC84019, 32, 133, OPCODES_4B),
+	PART("GD25LQ256D", 0xC86019, 32, 104, OPCODES_4B),
+};
+
+static const struct saf_spi_opcodes sfdp_3b_opcodes = OPCODES_3B;
+static const struct saf_spi_opcodes sfdp_4b_opcodes = OPCODES_4B;
+
+/* Basic flash parameter table fields, JESD216B, DWORDs numbered from 1 */
+#define BFPT_DW(n)			((n) - 1)
+#define BFPT_DW1_ERASE_4K_MASK		GENMASK(1, 0)
+#define BFPT_DW1_ERASE_4K		0x1U
+#define BFPT_DW1_DUAL_IO		BIT(20)
+#define BFPT_DW1_QUAD_IO		BIT(21)
+#define BFPT_DW2_DENSITY_LOG2		BIT(31)
+#define BFPT_DW3_QUAD_DUMMY(dw)		((dw) & 0x1FU)
+#define BFPT_DW3_QUAD_MODE(dw)		(((dw) >> 5) & 0x7U)
+#define BFPT_DW3_QUAD_OPCODE(dw)	(((dw) >> 8) & 0xFFU)
+/* DW8 and DW9 hold 4 erase types, size as log2 then opcode */
+#define BFPT_ERASE_TYPES		4U
+#define BFPT_DW12_NO_SUSPEND		BIT(31)
+#define BFPT_DW13_RESUME(dw)		(((dw) >> 16) & 0xFFU)
+#define BFPT_DW13_SUSPEND(dw)		(((dw) >> 24) & 0xFFU)
+#define BFPT_DW15_QER(dw)		(((dw) >> 20) & 0x7U)
+/* Volatile status register 1 write enabled by 50h */
+#define BFPT_DW16_WREN_VOLATILE		BIT(3)
+
+/* Quad enable requirements with QE in status 2 bit 1 */
+#define QER_SR2_BIT1_MASK		(BIT(1) | BIT(4) | BIT(5) | BIT(6))
+
+const struct saf_spi_part *saf_spi_part_find(uint32_t jedec_id)
+{
+	for (int i = 0; i < ARRAY_SIZE(parts); i++) {
+		if (parts[i].jedec_id == jedec_id) {
+			return &parts[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* SFDP only describes standard commands, status register and volatile write
+ * enable opcodes are only known for manufacturers of listed parts.
+ */
+static bool sfdp_manufacturer_known(uint32_t jedec_id)
+{
+	for (int i = 0; i < ARRAY_SIZE(parts); i++) {
+		if ((parts[i].jedec_id >> 16) == (jedec_id >> 16)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Erase types are described with 3-byte address opcodes */
+static uint8_t sfdp_erase_sizes(const uint32_t *bfpt)
+{
+	const struct saf_spi_opcodes *op = &sfdp_3b_opcodes;
+	uint8_t sizes = 0;
+
+	for (int i = 0; i < BFPT_ERASE_TYPES; i++) {
+		uint16_t type = bfpt[BFPT_DW(8) + i / 2] >> ((i % 2) * 16);
+		uint8_t opcode = type >> 8;
+
+		switch (type & 0xFFU) {
+		case 12:
+			sizes |= (opcode == op->erase_4k) ?
+				 SAF_PART_ERASE_4K : 0;
+			break;
+		case 15:
+			sizes |= (opcode == op->erase_32k) ?
+				 SAF_PART_ERASE_32K : 0;
+			break;
+		case 16:
+			sizes |= (opcode == op->erase_64k) ?
+				 SAF_PART_ERASE_64K : 0;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return sizes;
+}
+
+int saf_spi_part_from_sfdp(uint32_t jedec_id, const uint32_t *bfpt,
+			   struct saf_spi_part *part)
+{
+	uint32_t dw1 = bfpt[BFPT_DW(1)];
+	uint32_t dw2 = bfpt[BFPT_DW(2)];
+	uint32_t dw3 = bfpt[BFPT_DW(3)];
+	uint32_t dw13 = bfpt[BFPT_DW(13)];
+	const struct saf_spi_opcodes *op;
+	uint64_t bits;
+
+	if (!sfdp_manufacturer_known(jedec_id)) {
+		return -ENOTSUP;
+	}
+
+	if (dw2 & BFPT_DW2_DENSITY_LOG2) {
+		if ((dw2 & ~BFPT_DW2_DENSITY_LOG2) >= 63) {
+			return -ENOTSUP;
+		}
+		bits = BIT64(dw2 & ~BFPT_DW2_DENSITY_LOG2);
+	} else {
+		bits = (uint64_t)dw2 + 1;
+	}
+
+	/* SAF bridge needs 4KB erase and a dual or quad IO fast read */
+	if ((dw1 & BFPT_DW1_ERASE_4K_MASK) != BFPT_DW1_ERASE_4K ||
+	    !(dw1 & (BFPT_DW1_DUAL_IO | BFPT_DW1_QUAD_IO))) {
+		return -ENOTSUP;
+	}
+
+	memset(part, 0, sizeof(*part));
+	part->name = "SFDP";
+	part->jedec_id = jedec_id;
+	part->capacity_mb = bits / (8U * 1024U * 1024U);
+	part->max_freq_mhz = CONFIG_SAF_SPI_FREQ_MHZ;
+	part->qe_bit = BIT(1);
+	part->op = (part->capacity_mb > 16) ? sfdp_4b_opcodes :
+					      sfdp_3b_opcodes;
+	op = &part->op;
+
+	/* SAF bridge is programmed with all erase sizes and relies on
+	 * suspend/resume to let reads through erase and program.
+	 */
+	part->erase_sizes = sfdp_erase_sizes(bfpt);
+	if (part->erase_sizes != (SAF_PART_ERASE_4K | SAF_PART_ERASE_32K |
+				  SAF_PART_ERASE_64K)) {
+		return -ENOTSUP;
+	}
+
+	if ((bfpt[BFPT_DW(12)] & BFPT_DW12_NO_SUSPEND) ||
+	    BFPT_DW13_SUSPEND(dw13) != op->suspend ||
+	    BFPT_DW13_RESUME(dw13) != op->resume) {
+		return -ENOTSUP;
+	}
+
+	if (dw1 & BFPT_DW1_DUAL_IO) {
+		part->read_modes |= SAF_PART_DUAL_IO;
+		part->dual_dummy_clks = 4U;
+	}
+
+	/* Quad IO is only used with the standard opcode, with QE in status 2
+	 * set through volatile write when needed. Table describes 3-byte
+	 * address opcodes.
+	 */
+	if ((dw1 & BFPT_DW1_QUAD_IO) &&
+	    BFPT_DW3_QUAD_OPCODE(dw3) == sfdp_3b_opcodes.read_quad_io &&
+	    (QER_SR2_BIT1_MASK & BIT(BFPT_DW15_QER(bfpt[BFPT_DW(15)]))) &&
+	    (bfpt[BFPT_DW(16)] & BFPT_DW16_WREN_VOLATILE)) {
+		part->read_modes |= SAF_PART_QUAD_IO;
+		part->quad_dummy_clks = BFPT_DW3_QUAD_DUMMY(dw3) +
+					BFPT_DW3_QUAD_MODE(dw3);
+	}
+
+	return 0;
+}
+
+const struct saf_spi_part *saf_spi_part_default(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(parts); i++) {
+		if (parts[i].capacity_mb == CONFIG_SAF_SPI_CAPACITY) {
+			return &parts[i];
+		}
+	}
+
+	return &parts[0];
+}
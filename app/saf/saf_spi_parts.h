@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief SPI flash parts supported behind the SAF bridge.
+ *
+ * Parts are identified at runtime by JEDEC ID. Parts not listed are
+ * described from their SFDP basic flash parameter table when available.
+ */
+
+#ifndef __SAF_SPI_PARTS_H__
+#define __SAF_SPI_PARTS_H__
+
+#include <zephyr.h>
+
+/* Supported erase granularities */
+#define SAF_PART_ERASE_4K		BIT(0)
+#define SAF_PART_ERASE_32K		BIT(1)
+#define SAF_PART_ERASE_64K		BIT(2)
+
+/* Supported fast read modes */
+#define SAF_PART_DUAL_IO		BIT(0)
+#define SAF_PART_QUAD_IO		BIT(1)
+
+/* SFDP basic flash parameter table DWORDs read on detection, JESD216B */
+#define SAF_SFDP_BFPT_DWORDS		16U
+
+/**
+ * @brief Vendor specific opcodes.
+ *
+ * Parts over 16MB list the 4-byte address variants of erase, program and
+ * read opcodes.
+ */
+struct saf_spi_opcodes {
+	uint8_t rd_sts1;
+	uint8_t rd_sts2;
+	uint8_t wr_sts2;
+	uint8_t wr_en;
+	uint8_t wr_en_volatile;
+	uint8_t suspend;
+	uint8_t resume;
+	uint8_t erase_4k;
+	uint8_t erase_32k;
+	uint8_t erase_64k;
+	uint8_t program;
+	uint8_t read_dual_io;
+	uint8_t read_quad_io;
+};
+
+/**
+ * @brief SPI flash part description.
+ */
+struct saf_spi_part {
+	const char *name;
+	/* Manufacturer, memory type and capacity bytes */
+	uint32_t jedec_id;
+	uint8_t capacity_mb;
+	/* Max clock for fast read dual/quad IO with default dummy cycles */
+	uint8_t max_freq_mhz;
+	uint8_t read_modes;
+	/* Dummy clocks after address, including mode bits */
+	uint8_t dual_dummy_clks;
+	uint8_t quad_dummy_clks;
+	/* Quad enable bit in status register 2 */
+	uint8_t qe_bit;
+	uint8_t erase_sizes;
+	struct saf_spi_opcodes op;
+};
+
+/**
+ * @brief Look up a part by JEDEC ID.
+ *
+ * @param jedec_id manufacturer ID in bits 23:16, device ID in bits 15:0.
+ *
+ * @retval part description, NULL if part is unknown.
+ */
+const struct saf_spi_part *saf_spi_part_find(uint32_t jedec_id);
+
+/**
+ * @brief Describe an unknown part from its SFDP basic flash parameters.
+ *
+ * Only parts from manufacturers of listed parts are described, as status
+ * register and volatile write enable opcodes are taken from them. Erase
+ * types, suspend/resume opcodes and quad enable requirement reported by the
+ * table must match these opcodes. Clock is limited to
+ * CONFIG_SAF_SPI_FREQ_MHZ.
+ *
+ * @param jedec_id part JEDEC ID.
+ * @param bfpt first SAF_SFDP_BFPT_DWORDS of basic flash parameter table.
+ * @param part description filled in.
+ *
+ * @retval 0 if success, -ENOTSUP if parameters are not usable.
+ */
+int saf_spi_part_from_sfdp(uint32_t jedec_id, const uint32_t *bfpt,
+			   struct saf_spi_part *part);
+
+/**
+ * @brief Default part, used when detection fails.
+ *
+ * @retval part matching CONFIG_SAF_SPI_CAPACITY.
+ */
+const struct saf_spi_part *saf_spi_part_default(void);
+
+#endif /* __SAF_SPI_PARTS_H__ */
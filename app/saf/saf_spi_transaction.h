@@ -29,6 +29,8 @@ enum saf_command_index {
 	WRITE_ENABLE_INDEX,
 	WRITE_NV_REGISTER_INDEX,
 	READ_NV_REGISTER_INDEX,
+	/* Manufacturer and device ID, used to look up the part */
+	RD_JEDEC_ID_CMD_INDEX,
 };
 
 /**
@@ -60,6 +60,12 @@ static struct saf_spi_transaction winbond_qspi_cmds[] = {
 		.tx_len = 5,
 		.rx_len = 1,
 	},
+	[RD_JEDEC_ID_CMD_INDEX] = {
+		.buf = { READ_JEDEC_ID_OPCODE },
+		.tx_len = 1,
+		.rx_len = 3,
+		.mode = SPI_LINES_SINGLE,
+	},
 };
 
 /* SAF bridge Windbond configuration
@@ -71,41 +77,45 @@ static struct saf_spi_transaction winbond_qspi_cmds[] = {
  * Refer to espi_saf driver subystem for additional details.
  *
  */
-static const struct espi_saf_flash_cfg flash_w25qxxx = {
-#ifdef CONFIG_SOC_SERIES_MEC172X
-	.version = MCHP_SAF_VER_2,
-#endif
-	.flashsz = W25Q_CAPACITY_BYTES,
-	.opa = MCHP_SAF_OPCODE_REG_VAL(WRITE_ENABLE_OPCODE,
-				       ERASE_SUSPEND_OPCODE,
-				       ERASE_RESUME_OPCODE,
-				       READ_STATUS_1_OPCODE),
-	.opb = MCHP_SAF_OPCODE_REG_VAL(SECTOR_ERASE_OPCODE,
-				       BLOCK_ERASE_32K_OPCODE,
-				       BLOCK_ERASE_64K_OPCODE,
-				       PAGE_PROGRAM_OPCODE),
-	.opc = MCHP_SAF_OPCODE_REG_VAL(FAST_READ_IO_OPCODE,
-				       EXIT_QPI_OPCODE,
-				       CONTINUOUS_MODE_OPCODE,
-				       READ_STATUS_2_OPCODE),
-#ifdef CONFIG_SOC_SERIES_MEC172X
-	.opd = MCHP_SAF_OPCODE_REG_VAL(POWER_DOWN,
-				       RELEASE_POWER_DOWN,
-				       0U,
-				       0U),
-#endif
-	.cont_prefix = 0U,
-	.cs_cfg_descr_ids = MCHP_CS0_CFG_DESCR_IDX_REG_VAL,
-	.poll2_mask = SAF_POLL_MASK,
-	.flags = SAF_FLAGS,
-	.descr = {
-		SAF_DESCR_CM_RD_D0,
-		SAF_DESCR_CM_RD_D1,
-		SAF_DESCR_CM_RD_D2,
-		SAF_DESCR_ENTER_CM_D0,
-		SAF_DESCR_ENTER_CM_D1,
-		SAF_DESCR_ENTER_CM_D2
-	}
+#define FLASH_CFG_W25QXXX { \
+	IF_ENABLED(CONFIG_SOC_SERIES_MEC172X, (.version = MCHP_SAF_VER_2,)) \
+	.flashsz = W25Q_CAPACITY_BYTES, \
+	.opa = MCHP_SAF_OPCODE_REG_VAL(WRITE_ENABLE_OPCODE, \
+				       ERASE_SUSPEND_OPCODE, \
+				       ERASE_RESUME_OPCODE, \
+				       READ_STATUS_1_OPCODE), \
+	.opb = MCHP_SAF_OPCODE_REG_VAL(SECTOR_ERASE_OPCODE, \
+				       BLOCK_ERASE_32K_OPCODE, \
+				       BLOCK_ERASE_64K_OPCODE, \
+				       PAGE_PROGRAM_OPCODE), \
+	.opc = MCHP_SAF_OPCODE_REG_VAL(FAST_READ_IO_OPCODE, \
+				       EXIT_QPI_OPCODE, \
+				       CONTINUOUS_MODE_OPCODE, \
+				       READ_STATUS_2_OPCODE), \
+	IF_ENABLED(CONFIG_SOC_SERIES_MEC172X, \
+		   (.opd = MCHP_SAF_OPCODE_REG_VAL(POWER_DOWN, \
+						   RELEASE_POWER_DOWN, \
+						   0U, \
+						   0U),)) \
+	.cont_prefix = 0U, \
+	.cs_cfg_descr_ids = MCHP_CS0_CFG_DESCR_IDX_REG_VAL, \
+	.poll2_mask = SAF_POLL_MASK, \
+	.flags = SAF_FLAGS, \
+	.descr = { \
+		SAF_DESCR_CM_RD_D0, \
+		SAF_DESCR_CM_RD_D1, \
+		SAF_DESCR_CM_RD_D2, \
+		SAF_DESCR_ENTER_CM_D0, \
+		SAF_DESCR_ENTER_CM_D1, \
+		SAF_DESCR_ENTER_CM_D2 \
+	} \
+}
+
+/* One configuration per device, defaults are updated with the opcodes of
+ * the detected part.
+ */
+static struct espi_saf_flash_cfg flash_cfgs[CONFIG_SAF_SPI_DEVICES_COUNT] = {
+	[0 ... CONFIG_SAF_SPI_DEVICES_COUNT - 1] = FLASH_CFG_W25QXXX,
 };
 
 static const struct espi_saf_cfg saf_cfg = {
@@ -130,7 +140,7 @@ static const struct espi_saf_cfg saf_cfg = {
 			MCHP_SAF_TAG_MAP2_DFLT
 			},
 	},
-	.flash_cfgs = (struct espi_saf_flash_cfg *)&flash_w25qxxx
+	.flash_cfgs = flash_cfgs
 };
 
 const struct espi_saf_cfg *windbond_saf_cfg(void)
@@ -138,9 +148,43 @@ const struct espi_saf_cfg *windbond_saf_cfg(void)
 	return &saf_cfg;
 }
 
+bool windbond_saf_part_supported(const struct saf_spi_part *part)
+{
+	/* Address mode and read descriptors are fixed at build time */
+	if (part->capacity_mb != CONFIG_SAF_SPI_CAPACITY) {
+		return false;
+	}
+
+	if (SAF_READ_QUAD_IO) {
+		return (part->read_modes & SAF_PART_QUAD_IO) &&
+		       part->quad_dummy_clks == SAF_DESCR_QUAD_DUMMY_CLKS;
+	}
+
+	return (part->read_modes & SAF_PART_DUAL_IO) &&
+	       part->dual_dummy_clks == SAF_DESCR_DUAL_DUMMY_CLKS;
+}
+
+void windbond_saf_set_part(uint8_t dev, const struct saf_spi_part *part)
+{
+	struct espi_saf_flash_cfg *cfg = &flash_cfgs[dev];
+	const struct saf_spi_opcodes *op = &part->op;
+
+	cfg->flashsz = part->capacity_mb * 1024U * 1024U;
+	cfg->opa = MCHP_SAF_OPCODE_REG_VAL(op->wr_en, op->suspend, op->resume,
+					   op->rd_sts1);
+	cfg->opb = MCHP_SAF_OPCODE_REG_VAL(op->erase_4k, op->erase_32k,
+					   op->erase_64k, op->program);
+	cfg->opc = MCHP_SAF_OPCODE_REG_VAL(SAF_READ_QUAD_IO ?
+					   op->read_quad_io :
+					   op->read_dual_io,
+					   EXIT_QPI_OPCODE,
+					   CONTINUOUS_MODE_OPCODE,
+					   op->rd_sts2);
+}
+
 struct saf_spi_transaction *windbond_qspi_cmd(enum saf_command_index command)
 {
-	__ASSERT(command >= ARRAY_SIZE(winbond_qspi_cmds),
+	__ASSERT(command < ARRAY_SIZE(winbond_qspi_cmds),
 		 "Invalid index");
 	return &winbond_qspi_cmds[command];
 }
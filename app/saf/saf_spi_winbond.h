@@ -8,6 +8,20 @@
 #define __SAF_SPI_WINBOND_H__
 
 #include "spi_winbond_opcodes.h"
+#include "saf_spi_parts.h"
+
+/* Clocks between address and data expected by continuous read descriptors,
+ * including mode bits.
+ */
+#define SAF_DESCR_QUAD_DUMMY_CLKS	6U
+#define SAF_DESCR_DUAL_DUMMY_CLKS	4U
+
+/* Status register 1, erase/program/write status in progress */
+#define STATUS_1_BUSY_BIT		BIT(0)
+/* Status register 2, quad enable */
+#define STATUS_2_QE_BIT			BIT(1)
+/* Status register 2, erase/program suspended */
+#define STATUS_2_SUS_BIT		BIT(7)
 
 /* Adjust descriptors based on SPI capacity to simplify SAF structure */
 #if DT_NODE_HAS_STATUS(DT_NODELABEL(spi0), disabled)
@@ -16,8 +30,10 @@
 #define DT_SPI_INST	DT_NODELABEL(spi0)
 #if DT_PROP(DT_SPI_INST, lines) == 4
 #define FAST_READ_IO_OPCODE            FAST_READ_QUAD_IO_OPCODE
+#define SAF_READ_QUAD_IO               1
 #else
 #define FAST_READ_IO_OPCODE            FAST_READ_DUAL_IO_OPCODE
+#define SAF_READ_QUAD_IO               0
 #endif /* DT_PROP(DT_SPI_INST, lines) == 4 */
 #endif /* DT_NODE_HAS_STATUS(DT_NODELABEL(spi0), disabled) */
 
@@ -116,5 +132,24 @@ const struct espi_saf_cfg *windbond_saf_cfg(void);
  */
 struct saf_spi_transaction *windbond_qspi_cmd(enum saf_command_index command);
 
+/**
+ * @brief Check if a part can be used with Winbond SAF descriptors.
+ *
+ * Capacity and read mode must match the descriptors selected at build time.
+ *
+ * @param part detected part.
+ *
+ * @retval true if part can be used.
+ */
+bool windbond_saf_part_supported(const struct saf_spi_part *part);
+
+/**
+ * @brief Use detected part opcodes in SAF configuration of a device.
+ *
+ * @param dev SPI flash device index.
+ * @param part detected part.
+ */
+void windbond_saf_set_part(uint8_t dev, const struct saf_spi_part *part);
+
 #endif /* __SAF_SPI_WINBOND_H__ */
 
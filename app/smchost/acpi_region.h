@@ -265,8 +265,14 @@ struct acpi_tbl {
 	uint8_t acpi_dev_pwr_cntrl;
 	/* [201/C9] button SCIs enable/disable offset */
 	struct acpi_hid_btn_sci acpi_btn_cntrl;
-	/* [202/CA] */
-	uint8_t acpi_unused_v[7];
+	/* [202/CA] Rear fan speed */
+	uint16_t acpi_rear_fan_rpm;
+	/* [204/CC] Graphics fan speed */
+	uint16_t acpi_gfx_fan_rpm;
+	/* [206/CE] PCH fan speed */
+	uint16_t acpi_pch_fan_rpm;
+	/* [208/D0] Fan stall status, one bit per fan index */
+	uint8_t acpi_fan_stall_sts;
 	/* [209/D1] Battery B design capacity in mW */
 	uint16_t acpi_bat1_design_cap;
 	/* [211/D3] Battery A design capacity in mW */
@@ -13,6 +13,7 @@
 #include "smc.h"
 #include "smchost.h"
 #include "pwrplane.h"
+#include "pwrseq_notify.h"
 #include "espi_hub.h"
 #include "acpi.h"
 LOG_MODULE_REGISTER(sci, CONFIG_SMCHOST_LOG_LEVEL);
@@ -49,7 +50,7 @@ void generate_sci(void)
 		return;
 	}
 
-	if (pwrseq_system_state() == SYSTEM_S0_STATE) {
+	if (pwrseq_notify_host_in_s0()) {
 #ifdef CONFIG_SMCHOST_SCI_OVER_ESPI
 		ret = espihub_send_vw(ESPI_VWIRE_SIGNAL_SCI, ESPIHUB_VW_LOW);
 		if (ret) {
@@ -136,7 +137,7 @@ void enqueue_sci(uint8_t code)
 		return;
 	}
 
-	if (pwrseq_system_state() == SYSTEM_S0_STATE) {
+	if (pwrseq_notify_host_in_s0()) {
 		LOG_INF("enqueued SCI %02x", code);
 		ret = k_msgq_put(&sci_msgq, (void *)&code, K_NO_WAIT);
 		if (ret < 0) {
@@ -133,5 +133,7 @@
 #define SCI_THERMAL             0xF0
 /* Thermal trip point transition */
 #define SCI_THERMTRIP           0xF1
+/* Fan stall status change */
+#define SCI_FAN_STALL           0xF2
 
 #endif /* SCI_CODES_H_ */
@@ -8,6 +8,7 @@
 #include <zephyr.h>
 #include <device.h>
 #include <soc.h>
+#include <sys/byteorder.h>
 #include "gpio_ec.h"
 #include <logging/log.h>
 #include "smc.h"
@@ -631,25 +632,25 @@ static const bool acpi_tbl_attr[256] = {
 	/* [201 / C9] uint8_t acpi_dis_btn_sci; */
 	ACPI_ATTR_READ_WRITE,
 
-	/* [202 / CA] uint8_t acpi_unused_v[7]; */
+	/* [202 / CA] uint8_t acpi_rear_fan_rpm_l; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [203 / CB]  */
+	/* [203 / CB] uint8_t acpi_rear_fan_rpm_h; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [204 / CC]  */
+	/* [204 / CC] uint8_t acpi_gfx_fan_rpm_l; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [205 / CD]  */
+	/* [205 / CD] uint8_t acpi_gfx_fan_rpm_h; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [206 / CE]  */
+	/* [206 / CE] uint8_t acpi_pch_fan_rpm_l; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [207 / CF]  */
+	/* [207 / CF] uint8_t acpi_pch_fan_rpm_h; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [208 / D0]  */
+	/* [208 / D0] uint8_t acpi_fan_stall_sts; */
 	ACPI_ATTR_READ_ONLY,
 
 	/* [209 / D1] uint8_t acpi_bat_1_design_cap_l; */
@@ -796,6 +797,14 @@ static const bool acpi_tbl_attr[256] = {
 
 static uint8_t g_wake_status;
 
+/* ACPI offset of each fan speed, indexed by fan type */
+static const uint8_t fan_rpm_acpi_ofs[FAN_DEV_TOTAL] = {
+	[FAN_CPU] = offsetof(struct acpi_tbl, acpi_cpu_fan_rpm),
+	[FAN_REAR] = offsetof(struct acpi_tbl, acpi_rear_fan_rpm),
+	[FAN_GFX] = offsetof(struct acpi_tbl, acpi_gfx_fan_rpm),
+	[FAN_PCH] = offsetof(struct acpi_tbl, acpi_pch_fan_rpm),
+};
+
 uint8_t smc_get_wake_sts(void)
 {
 	return g_wake_status;
@@ -858,16 +867,22 @@ void smc_update_pch_dts_temperature(int temp)
 
 void smc_update_fan_tach(uint8_t fan_idx, uint16_t rpm)
 {
-	switch (fan_idx) {
-	case FAN_CPU:
-		g_acpi_tbl.acpi_cpu_fan_rpm = rpm;
-		break;
-
-	case FAN_REAR:
-	case FAN_GFX:
-	default:
+	if (fan_idx >= ARRAY_SIZE(fan_rpm_acpi_ofs)) {
 		LOG_WRN("Missing acpi fields for fan %d", fan_idx);
-		break;
+		return;
+	}
+
+	sys_put_le16(rpm, (uint8_t *)&g_acpi_tbl + fan_rpm_acpi_ofs[fan_idx]);
+}
+
+void smc_update_fan_stall(uint8_t fan_idx, bool stalled)
+{
+	uint8_t sts = g_acpi_tbl.acpi_fan_stall_sts;
+
+	WRITE_BIT(sts, fan_idx, stalled);
+	if (sts != g_acpi_tbl.acpi_fan_stall_sts) {
+		g_acpi_tbl.acpi_fan_stall_sts = sts;
+		enqueue_sci(SCI_FAN_STALL);
 	}
 }
 
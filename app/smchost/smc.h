@@ -82,6 +82,16 @@ void smc_update_thermal_sensor(enum acpi_thrm_sens_idx idx, int16_t temp);
  */
 void smc_update_fan_tach(uint8_t fan_idx, uint16_t rpm);
 
+/**
+ * @brief Update the fan stall status for given fan device.
+ *
+ * Host is notified via SCI when the status changes.
+ *
+ * @param fan_idx fan device index.
+ * @param stalled true if the fan is stalled or its tach failed.
+ */
+void smc_update_fan_stall(uint8_t fan_idx, bool stalled);
+
 /**
  * @brief Update thermal sensor trip status.
  *
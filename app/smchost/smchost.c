@@ -19,9 +19,14 @@
 #include "espi_hub.h"
 #include "peci_hub.h"
 #include "led.h"
+#include "task_handler.h"
+#include "postcodemgmt.h"
 #ifdef CONFIG_DNX_SUPPORT
 #include "dnx.h"
 #endif
+#ifdef CONFIG_THERMAL_PREDICTIVE_GUARD
+#include "thermal_guard.h"
+#endif
 
 LOG_MODULE_REGISTER(smchost, CONFIG_SMCHOST_LOG_LEVEL);
 
@@ -48,16 +53,18 @@ static uint8_t acpi_normal_flag;
 /* PLT_RST# status */
 static uint8_t pltrst_signal_sts;
 
+static EC_TASK_DEFINE(smchost_task, "SMC", 0, 0, EC_TASK_PSTATE_ANY);
+
 #ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
 /* Trigger from asynchronous events generated by other EC FW modules
  * of request from host.
  */
-static struct k_sem acpi_lock;
+#define SMCHOST_EVT_REQUEST	BIT(0)
 
 void smchost_signal_request(void)
 {
 	LOG_DBG("%s", __func__);
-	k_sem_give(&acpi_lock);
+	ec_task_post(&smchost_task, SMCHOST_EVT_REQUEST);
 }
 #endif
 
@@ -263,6 +270,14 @@ static void smchost_pltrst_handler(uint8_t pltrst_sts)
 	pltrst_signal_sts = pltrst_sts;
 	LOG_DBG("SCI enabled %d", g_acpi_state_flags.sci_enabled);
 
+	/* Host is being reset, PECI devices need to be rediscovered */
+	peci_invalidate_cache();
+
+	/* Keep postcodes of previous boot until a new one starts */
+	if (pltrst_sts) {
+		postcode_history_reset();
+	}
+
 #ifdef CONFIG_THERMAL_MANAGEMENT
 	if (pltrst_sts) {
 		peci_start_delay_timer();
@@ -288,10 +303,6 @@ static inline int smchost_task_init(void)
 	host_req_len = 0;
 	host_res_len = 0;
 
-#ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
-	k_sem_init(&acpi_lock, 0, 1);
-#endif
-
 	/* Initialize flags */
 	sci_queue_init();
 
@@ -376,7 +387,7 @@ void smchost_thread(void *p1, void *p2, void *p3)
 
 #ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
 	while (true) {
-		k_sem_take(&acpi_lock, K_FOREVER);
+		ec_task_wait(&smchost_task);
 		LOG_DBG("%s process\n", __func__);
 
 		/* 1) Process all smchost actions triggered by event
@@ -394,10 +405,14 @@ void smchost_thread(void *p1, void *p2, void *p3)
 		} while (pend_processing);
 	}
 #else
+	/* Host commands latency tolerates small delays to share wakeups */
+	smchost_task.slack_ms = period / 4U;
+	ec_task_set_period(&smchost_task, period);
+
 	while (true) {
 		/* Process tasks periodically*/
 		smchost_process_tasks();
-		k_msleep(period);
+		ec_task_wait(&smchost_task);
 	}
 #endif
 }
@@ -551,7 +566,11 @@ static void enable_acpi(void)
 	g_acpi_state_flags.acpi_mode = 1;
 
 	/* Disengage throttling */
-	gpio_write_pin(PROCHOT, 1);
+#ifdef CONFIG_THERMAL_PREDICTIVE_GUARD
+	thermal_guard_release_prochot();
+#else
+	gpio_write_pin(PROCHOT, !PROCHOT_ASSERT_LEVEL);
+#endif
 
 	/* Set ACPI sleep state level to S3 */
 	g_acpi_tbl.acpi_flags.sleep_s3 = 1;
@@ -600,6 +619,26 @@ static uint8_t smchost_req_length(uint8_t command)
 	case SMCHOST_WRITE_ACPI_SPACE:
 		return 2;
 
+#ifdef CONFIG_THERMAL_TELEMETRY
+	case SMCHOST_GET_THERMAL_LOG:
+		return 3;
+#endif
+
+#ifdef CONFIG_PWRSEQ_TRACE
+	case SMCHOST_GET_PWRSEQ_TRACE:
+		return 2;
+#endif
+
+#ifdef CONFIG_POSTCODE_HISTORY
+	case SMCHOST_GET_POSTCODE_LOG:
+		return 2;
+#endif
+
+#ifdef CONFIG_BINLOG
+	case SMCHOST_GET_BINARY_LOG:
+		return 2;
+#endif
+
 	default:
 		return 0;
 	}
@@ -621,6 +660,12 @@ static void smchost_cmd_handler(uint8_t command)
 	case SMCHOST_READ_REVISION:
 	case SMCHOST_READ_PLAT_SIGNATURE:
 	case SMCHOST_HID_BTN_SCI_CONTROL:
+#ifdef CONFIG_POSTCODE_HISTORY
+	case SMCHOST_GET_POSTCODE_LOG:
+#endif
+#ifdef CONFIG_BINLOG
+	case SMCHOST_GET_BINARY_LOG:
+#endif
 		smchost_cmd_info_handler(command);
 		break;
 	case SMCHOST_PLN_CONFIG:
@@ -640,6 +685,9 @@ static void smchost_cmd_handler(uint8_t command)
 	case SMCHOST_ENABLE_PWR_BTN_SW:
 	case SMCHOST_DISABLE_PWR_BTN_SW:
 	case SMCHOST_RESET_KSC:
+#ifdef CONFIG_PWRSEQ_TRACE
+	case SMCHOST_GET_PWRSEQ_TRACE:
+#endif
 #ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
 	case SMCHOST_DNX_TRIGGER:
 	case SMCHOST_DNX_SET_STRAP:
@@ -656,6 +704,9 @@ static void smchost_cmd_handler(uint8_t command)
 	case SMCHOST_SET_SHDWN_THRESHOLD:
 	case SMCHOST_SET_OS_ACTIVE_TRIP:
 	case SMCHOST_GET_HW_PERIPHERALS_STS:
+#ifdef CONFIG_THERMAL_TELEMETRY
+	case SMCHOST_GET_THERMAL_LOG:
+#endif
 		smchost_cmd_thermal_handler(command);
 		break;
 #endif
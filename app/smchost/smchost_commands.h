@@ -61,8 +61,20 @@
 #define SMCHOST_SET_TMP_THRESHOLD	0x4A
 #endif /* CONFIG_DTT_SUPPORT_THERMALS */
 #define SMCHOST_SET_SHDWN_THRESHOLD	0x58
+#ifdef CONFIG_THERMAL_TELEMETRY
+#define SMCHOST_GET_THERMAL_LOG		0x5B
+#endif
 #define SMCHOST_BIOS_FAN_CONTROL	0xFE
 #endif
+#ifdef CONFIG_PWRSEQ_TRACE
+#define SMCHOST_GET_PWRSEQ_TRACE	0x5C
+#endif
+#ifdef CONFIG_POSTCODE_HISTORY
+#define SMCHOST_GET_POSTCODE_LOG	0x5D
+#endif
+#ifdef CONFIG_BINLOG
+#define SMCHOST_GET_BINARY_LOG		0x5E
+#endif
 #ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
 #define SMCHOST_DNX_TRIGGER		0xF6
 #define SMCHOST_DNX_SET_STRAP		0xF7
@@ -15,6 +15,10 @@
 #include "espi_hub.h"
 #include "system.h"
 #include "flashhdr.h"
+#include "postcodemgmt.h"
+#ifdef CONFIG_BINLOG
+#include "binlog.h"
+#endif
 
 LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
 
@@ -163,6 +167,43 @@ static void read_platform_signature(void)
 	send_to_host((uint8_t *)value, 8);
 }
 
+#ifdef CONFIG_POSTCODE_HISTORY
+/**
+ * @brief Returns a chunk of postcode history since last platform reset.
+ *
+ *  Byte 1-2: chunk index (LSB first)
+ *
+ * Response is always POSTCODE_HIST_CHUNK_SIZE bytes, bytes past the end of
+ * the history are returned as 0xFF.
+ */
+static void get_postcode_log(void)
+{
+	uint8_t chunk[POSTCODE_HIST_CHUNK_SIZE];
+
+	postcode_history_read_chunk(host_req[1] | (host_req[2] << 8), chunk);
+	send_to_host(chunk, sizeof(chunk));
+}
+#endif
+
+#ifdef CONFIG_BINLOG
+/**
+ * @brief Returns a chunk of the binary log.
+ *
+ *  Byte 1-2: chunk index (LSB first)
+ *
+ * Chunk 0 starts a new read of the log. Response is always
+ * BINLOG_CHUNK_SIZE bytes, bytes past the end of the log are returned as
+ * 0xFF.
+ */
+static void get_binary_log(void)
+{
+	uint8_t chunk[BINLOG_CHUNK_SIZE];
+
+	binlog_read_chunk(host_req[1] | (host_req[2] << 8), chunk);
+	send_to_host(chunk, sizeof(chunk));
+}
+#endif
+
 static void get_shutdown_reason(void)
 {
 	uint8_t shutdown_status = read_shutdown_reason();
@@ -202,6 +243,16 @@ void smchost_cmd_info_handler(uint8_t command)
 	case SMCHOST_HID_BTN_SCI_CONTROL:
 		btn_sci_cntrl();
 		break;
+#ifdef CONFIG_POSTCODE_HISTORY
+	case SMCHOST_GET_POSTCODE_LOG:
+		get_postcode_log();
+		break;
+#endif
+#ifdef CONFIG_BINLOG
+	case SMCHOST_GET_BINARY_LOG:
+		get_binary_log();
+		break;
+#endif
 	default:
 		LOG_WRN("%s: command 0x%X without handler", __func__, command);
 		break;
@@ -16,6 +16,7 @@
 #include "acpi.h"
 #include "pwrplane.h"
 #include "pwrseq_utils.h"
+#include "pwrseq_notify.h"
 #include "dswmode.h"
 #include "pseudog3.h"
 #include "kbchost.h"
@@ -23,6 +24,9 @@
 #ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
 #include "dnx_ec_assisted_trigger.h"
 #endif
+#ifdef CONFIG_PWRSEQ_TRACE
+#include "pwrseq_trace.h"
+#endif
 LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
 
 static bool pwrbtn_notify;
@@ -225,6 +229,7 @@ static void cs_entry(void)
 	}
 #endif
 	cs_state = true;
+	pwrseq_notify_update();
 }
 
 static void cs_exit(void)
@@ -235,10 +240,7 @@ static void cs_exit(void)
 	}
 #endif
 	cs_state = false;
-
-#ifdef CONFIG_THERMAL_MANAGEMENT
-	thermalmgmt_handle_cs_exit();
-#endif
+	pwrseq_notify_update();
 }
 
 static void get_legacy_wake_sts(void)
@@ -251,6 +253,24 @@ static void clear_legacy_wake_sts(void)
 	legacy_wake_status = 0;
 }
 
+#ifdef CONFIG_PWRSEQ_TRACE
+/**
+ * @brief Returns a chunk of power sequence trace log.
+ *
+ *  Byte 1-2: chunk index (LSB first)
+ *
+ * Response is always PWRSEQ_TRACE_CHUNK_SIZE bytes, bytes past the end of
+ * the log are returned as 0xFF.
+ */
+static void get_pwrseq_trace(void)
+{
+	uint8_t chunk[PWRSEQ_TRACE_CHUNK_SIZE];
+
+	pwrseq_trace_read_chunk(host_req[1] | (host_req[2] << 8), chunk);
+	send_to_host(chunk, sizeof(chunk));
+}
+#endif
+
 void smchost_cmd_pm_handler(uint8_t command)
 {
 	switch (command) {
@@ -316,6 +336,11 @@ void smchost_cmd_pm_handler(uint8_t command)
 	case SMCHOST_RESET_KSC:
 		ec_reset();
 		break;
+#ifdef CONFIG_PWRSEQ_TRACE
+	case SMCHOST_GET_PWRSEQ_TRACE:
+		get_pwrseq_trace();
+		break;
+#endif
 	default:
 		LOG_WRN("%s: command 0x%X without handler", __func__, command);
 		break;
@@ -17,6 +17,9 @@
 #ifdef CONFIG_DTT_SUPPORT_THERMALS
 #include "dtt.h"
 #endif
+#ifdef CONFIG_THERMAL_TELEMETRY
+#include "thermal_telemetry.h"
+#endif
 
 LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
 
@@ -99,6 +102,29 @@ static void update_hw_peripherals_status(void)
 	send_to_host(hw_peripherals_sts, sizeof(hw_peripherals_sts));
 }
 
+#ifdef CONFIG_THERMAL_TELEMETRY
+/**
+ * @brief Returns a chunk of thermal telemetry log.
+ *
+ *  Byte 1: log source, 0 = live history, 1 = last thermal shutdown
+ *  Byte 2-3: chunk index (LSB first)
+ *
+ * Response is always TELEM_CHUNK_SIZE bytes, bytes past the end of the log
+ * are returned as 0xFF.
+ */
+static void get_thermal_log(void)
+{
+	uint8_t chunk[TELEM_CHUNK_SIZE];
+	uint16_t idx = host_req[2] | (host_req[3] << 8);
+
+	if (thermal_telemetry_read_chunk(host_req[1], idx, chunk)) {
+		memset(chunk, 0xFF, sizeof(chunk));
+	}
+
+	send_to_host(chunk, sizeof(chunk));
+}
+#endif
+
 void smchost_cmd_thermal_handler(uint8_t command)
 {
 	switch (command) {
@@ -122,6 +148,11 @@ void smchost_cmd_thermal_handler(uint8_t command)
 	case SMCHOST_GET_HW_PERIPHERALS_STS:
 		update_hw_peripherals_status();
 		break;
+#ifdef CONFIG_THERMAL_TELEMETRY
+	case SMCHOST_GET_THERMAL_LOG:
+		get_thermal_log();
+		break;
+#endif
 	default:
 		LOG_WRN("%s: command 0x%X without handler", __func__, command);
 		break;
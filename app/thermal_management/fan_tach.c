@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <logging/log.h>
+#include "fan.h"
+#include "fan_tach.h"
+
+LOG_MODULE_DECLARE(thermal, CONFIG_THERMAL_MGMT_LOG_LEVEL);
+
+#define TACH_WINDOW		CONFIG_THERMAL_FAN_TACH_WINDOW
+
+BUILD_ASSERT((TACH_WINDOW & (TACH_WINDOW - 1)) == 0,
+	     "Tach window must be a power of 2");
+
+struct fan_tach {
+	uint16_t samples[TACH_WINDOW];
+	uint32_t sum;
+	uint8_t idx;
+	uint8_t cnt;
+	/* Consecutive tach read failures */
+	uint8_t err_cnt;
+	/* Consecutive evaluations contradicting current stall status */
+	uint8_t stall_cnt;
+	bool stalled;
+};
+
+static struct fan_tach tach[FAN_DEV_TOTAL];
+static uint8_t tach_fans;
+static struct k_spinlock tach_lock;
+static struct k_work_delayable tach_work;
+static bool sampling;
+
+static void fan_tach_add_sample(struct fan_tach *fan, uint16_t rpm)
+{
+	fan->sum -= fan->samples[fan->idx];
+	fan->samples[fan->idx] = rpm;
+	fan->sum += rpm;
+	fan->idx = (fan->idx + 1) & (TACH_WINDOW - 1);
+	if (fan->cnt < TACH_WINDOW) {
+		fan->cnt++;
+	}
+}
+
+static void fan_tach_work_handler(struct k_work *work)
+{
+	k_spinlock_key_t key;
+	uint16_t rpm;
+	int ret;
+
+	for (uint8_t idx = 0; idx < tach_fans; idx++) {
+		ret = fan_read_rpm(idx, &rpm);
+
+		key = k_spin_lock(&tach_lock);
+		if (ret) {
+			if (tach[idx].err_cnt < UINT8_MAX) {
+				tach[idx].err_cnt++;
+			}
+		} else {
+			tach[idx].err_cnt = 0;
+			fan_tach_add_sample(&tach[idx], rpm);
+		}
+		k_spin_unlock(&tach_lock, key);
+	}
+
+	if (sampling) {
+		k_work_reschedule(&tach_work,
+			K_MSEC(CONFIG_THERMAL_FAN_TACH_SAMPLING_PERIOD_MS));
+	}
+}
+
+void fan_tach_init(uint8_t fans)
+{
+	tach_fans = MIN(fans, FAN_DEV_TOTAL);
+	k_work_init_delayable(&tach_work, fan_tach_work_handler);
+}
+
+void fan_tach_start(void)
+{
+	k_spinlock_key_t key;
+
+	if (sampling) {
+		return;
+	}
+
+	key = k_spin_lock(&tach_lock);
+	for (uint8_t idx = 0; idx < tach_fans; idx++) {
+		memset(tach[idx].samples, 0, sizeof(tach[idx].samples));
+		tach[idx].sum = 0;
+		tach[idx].idx = 0;
+		tach[idx].cnt = 0;
+		tach[idx].err_cnt = 0;
+		tach[idx].stall_cnt = 0;
+	}
+	k_spin_unlock(&tach_lock, key);
+
+	sampling = true;
+	k_work_reschedule(&tach_work, K_NO_WAIT);
+	LOG_DBG("Tach sampling started");
+}
+
+void fan_tach_stop(void)
+{
+	if (!sampling) {
+		return;
+	}
+
+	sampling = false;
+	k_work_cancel_delayable(&tach_work);
+	LOG_DBG("Tach sampling stopped");
+}
+
+uint16_t fan_tach_get_rpm(enum fan_type idx)
+{
+	k_spinlock_key_t key;
+	uint16_t rpm = 0;
+
+	if (idx >= tach_fans) {
+		return 0;
+	}
+
+	key = k_spin_lock(&tach_lock);
+	if (tach[idx].cnt) {
+		rpm = tach[idx].sum / tach[idx].cnt;
+	}
+	k_spin_unlock(&tach_lock, key);
+
+	return rpm;
+}
+
+bool fan_tach_check_stall(enum fan_type idx, uint8_t duty_cycle,
+			  bool *stalled)
+{
+	struct fan_tach *fan;
+	k_spinlock_key_t key;
+	bool fault = false;
+	bool changed = false;
+	uint8_t limit;
+
+	if (idx >= tach_fans) {
+		*stalled = false;
+		return false;
+	}
+
+	fan = &tach[idx];
+	key = k_spin_lock(&tach_lock);
+
+	/* Tach not responding at all is treated as failed fan */
+	if (fan->err_cnt >= TACH_WINDOW) {
+		fault = true;
+	} else if (fan->cnt == TACH_WINDOW &&
+		   duty_cycle >= CONFIG_THERMAL_FAN_STALL_MIN_DUTY &&
+		   (fan->sum / TACH_WINDOW) < CONFIG_THERMAL_FAN_STALL_RPM) {
+		fault = true;
+	}
+
+	if (fault == fan->stalled) {
+		fan->stall_cnt = 0;
+	} else {
+		limit = fault ? CONFIG_THERMAL_FAN_STALL_ASSERT_CNT :
+				CONFIG_THERMAL_FAN_STALL_CLEAR_CNT;
+		if (++fan->stall_cnt >= limit) {
+			fan->stalled = fault;
+			fan->stall_cnt = 0;
+			changed = true;
+		}
+	}
+
+	*stalled = fan->stalled;
+	k_spin_unlock(&tach_lock, key);
+
+	if (changed) {
+		LOG_WRN("Fan %d %s", idx, *stalled ? "stalled" : "recovered");
+	}
+
+	return changed;
+}
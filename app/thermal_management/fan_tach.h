@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __FAN_TACH_H__
+#define __FAN_TACH_H__
+
+#include "fan.h"
+
+/**
+ * @brief Initialize fan tach monitoring.
+ *
+ * @param fans number of fan devices in the board fan table.
+ */
+void fan_tach_init(uint8_t fans);
+
+/**
+ * @brief Start periodic tach sampling.
+ *
+ * Sampling is performed in the system workqueue so the thermal control path
+ * never waits for a tach read. Averaging windows are restarted, so any
+ * stale data from before fans were powered down is discarded.
+ */
+void fan_tach_start(void);
+
+/**
+ * @brief Stop periodic tach sampling, e.g. when fans are powered down.
+ */
+void fan_tach_stop(void);
+
+/**
+ * @brief Get fan speed averaged over the sampling window.
+ *
+ * @param idx fan device index.
+ *
+ * @retval fan speed in rpm, 0 if no valid sample is available.
+ */
+uint16_t fan_tach_get_rpm(enum fan_type idx);
+
+/**
+ * @brief Evaluate stall condition for a fan.
+ *
+ * A fan is considered stalled when it is driven above the stall duty cycle
+ * threshold but its average speed stays below the stall rpm threshold, or
+ * when its tach cannot be read. Stall status changes only after the
+ * condition persisted for the configured number of evaluations.
+ *
+ * @param idx fan device index.
+ * @param duty_cycle current fan duty cycle.
+ * @param stalled updated with current stall status.
+ *
+ * @retval true if stall status changed.
+ */
+bool fan_tach_check_stall(enum fan_type idx, uint8_t duty_cycle,
+			  bool *stalled);
+
+#endif /* __FAN_TACH_H__ */
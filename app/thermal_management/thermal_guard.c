@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <logging/log.h>
+#include "board_config.h"
+#include "gpio_ec.h"
+#include "thermal_guard.h"
+#ifdef CONFIG_THERMAL_TELEMETRY
+#include "thermal_telemetry.h"
+#endif
+
+LOG_MODULE_DECLARE(thermal, CONFIG_THERMAL_MGMT_LOG_LEVEL);
+
+#define GUARD_HIST_SIZE		CONFIG_THERMAL_GUARD_HISTORY
+
+/* Slope is kept in fixed point, 1/16 degree C per sample */
+#define GUARD_SLOPE_SHIFT	4
+
+static uint8_t hist[GUARD_HIST_SIZE];
+static uint8_t hist_idx;
+static uint8_t hist_cnt;
+static int slope;
+
+static bool throttling;
+static int64_t throttle_time;
+
+static int last_notify_temp;
+static int64_t last_notify_time;
+
+/* Least squares fit of samples against sample index, oldest sample is 0 */
+static int guard_calc_slope(void)
+{
+	int32_t sum_x = 0, sum_y = 0, sum_xy = 0, sum_xx = 0;
+	int32_t n = hist_cnt;
+	int32_t den;
+	uint8_t idx;
+
+	if (n < 2) {
+		return 0;
+	}
+
+	idx = (hist_idx + GUARD_HIST_SIZE - n) % GUARD_HIST_SIZE;
+	for (int32_t x = 0; x < n; x++) {
+		int32_t y = hist[idx];
+
+		sum_x += x;
+		sum_y += y;
+		sum_xy += x * y;
+		sum_xx += x * x;
+		idx = (idx + 1) % GUARD_HIST_SIZE;
+	}
+
+	den = (n * sum_xx) - (sum_x * sum_x);
+
+	return (((n * sum_xy) - (sum_x * sum_y)) << GUARD_SLOPE_SHIFT) / den;
+}
+
+static void guard_write_prochot(bool assert)
+{
+	gpio_write_pin(PROCHOT, assert ? PROCHOT_ASSERT_LEVEL :
+			       !PROCHOT_ASSERT_LEVEL);
+}
+
+static void guard_set_prochot(bool assert)
+{
+	if (throttling == assert) {
+		return;
+	}
+
+	throttling = assert;
+	guard_write_prochot(assert);
+
+	if (assert) {
+		throttle_time = k_uptime_get();
+	}
+
+	LOG_WRN("Predictive PROCHOT %s", assert ? "asserted" : "released");
+
+#ifdef CONFIG_THERMAL_TELEMETRY
+	thermal_telemetry_event(assert ? TELEM_EVT_PROCHOT_ASSERT :
+					 TELEM_EVT_PROCHOT_DEASSERT);
+#endif
+}
+
+static void guard_manage_prochot(int temp, int crit_temp)
+{
+	int projected = temp;
+
+	/* Only rising temperature can lead to a shutdown */
+	if (slope > 0) {
+		projected += (slope * CONFIG_THERMAL_GUARD_HORIZON) >>
+			     GUARD_SLOPE_SHIFT;
+	}
+
+	if (!throttling) {
+		if (projected >= crit_temp) {
+			LOG_WRN("Temp %d projected %d crit %d", temp,
+				projected, crit_temp);
+			guard_set_prochot(true);
+		}
+		return;
+	}
+
+	/* Keep throttling for a minimum time to avoid oscillation */
+	if ((k_uptime_get() - throttle_time) <
+	    CONFIG_THERMAL_GUARD_PROCHOT_MIN_MS) {
+		return;
+	}
+
+	if (projected < (crit_temp - CONFIG_THERMAL_GUARD_HYSTERESIS)) {
+		guard_set_prochot(false);
+	}
+}
+
+static bool guard_need_notify(int temp, bool state_change)
+{
+	int64_t now = k_uptime_get();
+
+	if (temp == last_notify_temp) {
+		return false;
+	}
+
+	/* Throttling changes are reported right away */
+	if (!state_change && ((now - last_notify_time) <
+	    CONFIG_THERMAL_GUARD_SCI_INTERVAL_MS)) {
+		return false;
+	}
+
+	last_notify_temp = temp;
+	last_notify_time = now;
+
+	return true;
+}
+
+bool thermal_guard_update(int temp, int crit_temp)
+{
+	bool prev_throttling = throttling;
+
+	hist[hist_idx] = MIN(MAX(temp, 0), UINT8_MAX);
+	hist_idx = (hist_idx + 1) % GUARD_HIST_SIZE;
+	if (hist_cnt < GUARD_HIST_SIZE) {
+		hist_cnt++;
+	}
+
+	slope = guard_calc_slope();
+	LOG_DBG("Temp %d slope %d/16 per sample", temp, slope);
+
+	guard_manage_prochot(temp, crit_temp);
+
+	return guard_need_notify(temp, prev_throttling != throttling);
+}
+
+void thermal_guard_reset(void)
+{
+	hist_cnt = 0;
+	slope = 0;
+	guard_set_prochot(false);
+}
+
+void thermal_guard_release_prochot(void)
+{
+	guard_set_prochot(false);
+	/* Boards may assert PROCHOT from boot, not known to the guard */
+	guard_write_prochot(false);
+}
+
+bool thermal_guard_is_throttling(void)
+{
+	return throttling;
+}
+
+int thermal_guard_get_slope(void)
+{
+	return slope;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __THERMAL_GUARD_H__
+#define __THERMAL_GUARD_H__
+
+/**
+ * Predictive thermal guard
+ * ------------------------------------------------------
+ * Keeps a short history of CPU temperature samples and estimates the
+ * temperature slope using a least squares fit. When the temperature
+ * projected CONFIG_THERMAL_GUARD_HORIZON samples ahead reaches the critical
+ * threshold PROCHOT# is asserted, so the CPU is throttled before EC has to
+ * initiate a thermal shutdown.
+ *
+ * Host notifications are rate limited rather than sent on a fixed delta,
+ * so fast temperature changes are reported promptly without flooding the
+ * host during bursty workloads.
+ */
+
+/**
+ * @brief Feed a new CPU temperature sample into the guard.
+ *
+ * Updates the temperature slope estimation and drives PROCHOT# accordingly.
+ *
+ * @param temp current CPU temperature.
+ * @param crit_temp critical temperature that triggers EC shutdown.
+ *
+ * @retval true if host should be notified about the temperature change.
+ */
+bool thermal_guard_update(int temp, int crit_temp);
+
+/**
+ * @brief Discard temperature history and release PROCHOT# if asserted.
+ *
+ * Intended to be called when CPU temperature is no longer monitored, e.g.
+ * when leaving S0.
+ */
+void thermal_guard_reset(void);
+
+/**
+ * @brief Release PROCHOT#, whoever asserted it.
+ *
+ * Used when host takes over thermal management, e.g. ACPI is enabled. The
+ * guard may assert PROCHOT# again on next temperature sample.
+ */
+void thermal_guard_release_prochot(void);
+
+/**
+ * @brief Indicate if the guard is currently throttling the CPU.
+ *
+ * @retval true if PROCHOT# is asserted by the guard.
+ */
+bool thermal_guard_is_throttling(void);
+
+/**
+ * @brief Get last estimated CPU temperature slope.
+ *
+ * @retval slope in 1/16 degree C per sample.
+ */
+int thermal_guard_get_slope(void);
+
+#endif /* __THERMAL_GUARD_H__ */
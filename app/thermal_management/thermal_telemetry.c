@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <logging/log.h>
+#include "eeprom.h"
+#include "thermal_telemetry.h"
+
+LOG_MODULE_DECLARE(thermal, CONFIG_THERMAL_MGMT_LOG_LEVEL);
+
+#define TELEM_BLK_SIZE		CONFIG_THERMAL_TELEMETRY_BLOCK_SIZE
+#define TELEM_BLK_COUNT		CONFIG_THERMAL_TELEMETRY_BLOCKS
+#define TELEM_FLUSH_BLKS	CONFIG_THERMAL_TELEMETRY_FLUSH_BLOCKS
+
+/* Block header: sequence number and used bytes */
+#define TELEM_BLK_SEQ		0u
+#define TELEM_BLK_USED		1u
+#define TELEM_BLK_HDR_SIZE	2u
+
+/* Keyframe: header, uptime, all fields with 2 bytes rpm */
+#define TELEM_KEYFRAME_SIZE	(1u + 4u + TELEM_FIELD_TOTAL + 1u)
+
+/* Export stream header */
+#define TELEM_HDR_SIZE		8u
+
+/* Stream is written to EEPROM one page at a time */
+#define TELEM_EEPROM_PAGE	CONFIG_EEPROM_PAGE_SIZE
+
+#define TELEM_IDLE_MAX		TELEM_REC_DATA_MASK
+
+/* Flush runs a few EEPROM page writes, each with ACK polling */
+#define TELEM_FLUSH_STACK_SIZE	1024
+
+#define TELEM_SHUTDOWN_LOG_SIZE	(TELEM_HDR_SIZE + \
+				 (TELEM_FLUSH_BLKS * TELEM_BLK_SIZE))
+
+BUILD_ASSERT(TELEM_BLK_SIZE <= UINT8_MAX, "Block size must fit in a byte");
+BUILD_ASSERT(TELEM_FLUSH_BLKS <= TELEM_BLK_COUNT,
+	     "Cannot flush more blocks than available");
+
+struct telem_view {
+	const uint8_t *blocks;
+	uint8_t first;
+	uint8_t count;
+};
+
+/* Thermal management and smchost run as cooperative threads, hence ring
+ * updates and host reads cannot interleave.
+ */
+static uint8_t ring[TELEM_BLK_COUNT][TELEM_BLK_SIZE];
+static uint8_t cur_blk = TELEM_BLK_COUNT - 1;
+static uint8_t blks_used;
+static uint8_t blk_seq;
+static uint8_t *idle_rec;
+static uint8_t decimation_cnt;
+
+/* Last state as seen by the decoder */
+static struct telem_sample last;
+static bool have_last;
+
+/* Live export is latched on chunk 0 read */
+static struct telem_view live_view;
+
+static uint8_t shutdown_log[TELEM_SHUTDOWN_LOG_SIZE];
+static bool shutdown_log_valid;
+
+static inline uint8_t *telem_cur_block(void)
+{
+	return ring[cur_blk];
+}
+
+static void telem_put(const uint8_t *rec, uint8_t len)
+{
+	uint8_t *blk = telem_cur_block();
+
+	memcpy(&blk[blk[TELEM_BLK_USED]], rec, len);
+	blk[TELEM_BLK_USED] += len;
+}
+
+static void telem_put_keyframe(void)
+{
+	uint32_t now = k_uptime_get_32();
+	uint8_t rec[TELEM_KEYFRAME_SIZE] = {
+		TELEM_REC_KEYFRAME,
+		now & 0xFF, (now >> 8) & 0xFF,
+		(now >> 16) & 0xFF, (now >> 24) & 0xFF,
+		last.cpu_temp,
+		last.gpu_temp,
+		last.pch_temp,
+		last.fan_duty,
+		last.fan_rpm & 0xFF, (last.fan_rpm >> 8) & 0xFF,
+		last.flags,
+	};
+
+	telem_put(rec, sizeof(rec));
+}
+
+static void telem_new_block(void)
+{
+	uint8_t *blk;
+
+	cur_blk = (cur_blk + 1) % TELEM_BLK_COUNT;
+	if (blks_used < TELEM_BLK_COUNT) {
+		blks_used++;
+	}
+
+	blk = telem_cur_block();
+	blk[TELEM_BLK_SEQ] = blk_seq++;
+	blk[TELEM_BLK_USED] = TELEM_BLK_HDR_SIZE;
+	idle_rec = NULL;
+
+	telem_put_keyframe();
+}
+
+/* Returns false if a new block was started. New block keyframe already
+ * holds the latest state, so delta records do not need to be stored.
+ */
+static bool telem_reserve(uint8_t len)
+{
+	if (telem_cur_block()[TELEM_BLK_USED] + len <= TELEM_BLK_SIZE) {
+		return true;
+	}
+
+	telem_new_block();
+	return false;
+}
+
+static bool telem_delta(int val, int8_t *delta)
+{
+	if (val < INT8_MIN || val > INT8_MAX) {
+		return false;
+	}
+
+	*delta = val;
+	return true;
+}
+
+void thermal_telemetry_record(const struct telem_sample *sample)
+{
+	uint8_t rec[1 + TELEM_FIELD_TOTAL];
+	int8_t *delta = (int8_t *)&rec[1];
+	uint8_t len = 1;
+	int rpm_units;
+	bool fits = true;
+
+	if (decimation_cnt++ % CONFIG_THERMAL_TELEMETRY_DECIMATION) {
+		return;
+	}
+
+	if (!have_last) {
+		last = *sample;
+		have_last = true;
+		telem_new_block();
+		return;
+	}
+
+	rec[0] = TELEM_REC_DELTA;
+	rpm_units = ((int)sample->fan_rpm - (int)last.fan_rpm) /
+		    (int)TELEM_RPM_DELTA_UNIT;
+
+	int diff[TELEM_FIELD_TOTAL] = {
+		[TELEM_FIELD_CPU_TEMP] = sample->cpu_temp - last.cpu_temp,
+		[TELEM_FIELD_GPU_TEMP] = sample->gpu_temp - last.gpu_temp,
+		[TELEM_FIELD_PCH_TEMP] = sample->pch_temp - last.pch_temp,
+		[TELEM_FIELD_FAN_DUTY] = sample->fan_duty - last.fan_duty,
+		[TELEM_FIELD_FAN_RPM] = rpm_units,
+		[TELEM_FIELD_FLAGS] = sample->flags - last.flags,
+	};
+
+	for (uint8_t idx = 0; idx < TELEM_FIELD_TOTAL; idx++) {
+		if (diff[idx] == 0) {
+			continue;
+		}
+
+		rec[0] |= BIT(idx);
+		fits &= telem_delta(diff[idx], &delta[len - 1]);
+		len++;
+	}
+
+	if (!fits) {
+		/* Change too big to be delta-encoded, store full state */
+		last = *sample;
+		idle_rec = NULL;
+		if (telem_reserve(TELEM_KEYFRAME_SIZE)) {
+			telem_put_keyframe();
+		}
+		return;
+	}
+
+	if (len == 1) {
+		if (idle_rec && (*idle_rec & TELEM_REC_DATA_MASK) <
+		    TELEM_IDLE_MAX) {
+			(*idle_rec)++;
+			return;
+		}
+
+		if (telem_reserve(1)) {
+			idle_rec = &telem_cur_block()[
+					telem_cur_block()[TELEM_BLK_USED]];
+			rec[0] = TELEM_REC_IDLE | 1;
+			telem_put(rec, 1);
+		}
+		return;
+	}
+
+	/* Keep same quantization as decoder for fan rpm */
+	last.cpu_temp = sample->cpu_temp;
+	last.gpu_temp = sample->gpu_temp;
+	last.pch_temp = sample->pch_temp;
+	last.fan_duty = sample->fan_duty;
+	last.fan_rpm += rpm_units * TELEM_RPM_DELTA_UNIT;
+	last.flags = sample->flags;
+
+	idle_rec = NULL;
+	if (telem_reserve(len)) {
+		telem_put(rec, len);
+	}
+}
+
+void thermal_telemetry_event(enum telem_event evt)
+{
+	uint8_t rec = TELEM_REC_EVENT | (evt & TELEM_REC_DATA_MASK);
+
+	/* Events are only meaningful after first sample */
+	if (!have_last) {
+		return;
+	}
+
+	idle_rec = NULL;
+	telem_reserve(sizeof(rec));
+	telem_put(&rec, sizeof(rec));
+}
+
+static void telem_latest_view(struct telem_view *view, uint8_t count)
+{
+	view->blocks = &ring[0][0];
+	view->count = MIN(count, blks_used);
+	view->first = (cur_blk + TELEM_BLK_COUNT + 1 - view->count) %
+		      TELEM_BLK_COUNT;
+}
+
+static uint8_t telem_stream_byte(const struct telem_view *view, uint32_t ofs)
+{
+	uint32_t blk;
+
+	if (ofs < TELEM_HDR_SIZE) {
+		uint8_t hdr[TELEM_HDR_SIZE] = {
+			TELEM_LOG_MAGIC & 0xFF, TELEM_LOG_MAGIC >> 8,
+			TELEM_LOG_VERSION, TELEM_BLK_SIZE, view->count,
+		};
+
+		return hdr[ofs];
+	}
+
+	ofs -= TELEM_HDR_SIZE;
+	blk = ofs / TELEM_BLK_SIZE;
+	if (blk >= view->count) {
+		return 0xFF;
+	}
+
+	blk = (view->first + blk) % TELEM_BLK_COUNT;
+
+	return view->blocks[(blk * TELEM_BLK_SIZE) + (ofs % TELEM_BLK_SIZE)];
+}
+
+/* Runs on flush queue, ring is not updated anymore once thermal management
+ * has entered shutdown.
+ */
+static void telem_flush_handler(struct k_work *work)
+{
+	struct telem_view view;
+	uint8_t page[TELEM_EEPROM_PAGE];
+	uint16_t size;
+	int ret;
+
+	telem_latest_view(&view, TELEM_FLUSH_BLKS);
+	size = TELEM_HDR_SIZE + (view.count * TELEM_BLK_SIZE);
+
+	LOG_WRN("Saving %d telemetry blocks", view.count);
+
+	for (uint16_t ofs = 0; ofs < size; ofs += sizeof(page)) {
+		uint8_t len = MIN(sizeof(page), size - ofs);
+
+		for (uint8_t i = 0; i < len; i++) {
+			page[i] = telem_stream_byte(&view, ofs + i);
+		}
+
+		ret = eeprom_write_block(
+			CONFIG_THERMAL_TELEMETRY_EEPROM_OFFSET + ofs,
+			len, page);
+		if (ret) {
+			LOG_ERR("Failed to save telemetry %d", ret);
+			return;
+		}
+	}
+}
+
+/* EEPROM writes take tens of ms, keep them off the system workqueue which
+ * also serves GPIO snapshots used by power sequencing.
+ */
+static K_THREAD_STACK_DEFINE(telem_flush_stack, TELEM_FLUSH_STACK_SIZE);
+static struct k_work_q telem_flush_queue;
+static K_WORK_DEFINE(telem_flush_work, telem_flush_handler);
+
+void thermal_telemetry_flush(void)
+{
+	k_work_submit_to_queue(&telem_flush_queue, &telem_flush_work);
+}
+
+void thermal_telemetry_init(void)
+{
+	uint16_t size;
+	int ret;
+
+	k_work_queue_start(&telem_flush_queue, telem_flush_stack,
+			   K_THREAD_STACK_SIZEOF(telem_flush_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, NULL);
+
+	ret = eeprom_read_block(CONFIG_THERMAL_TELEMETRY_EEPROM_OFFSET,
+				TELEM_HDR_SIZE, shutdown_log);
+	if (ret) {
+		LOG_ERR("Failed to read telemetry %d", ret);
+		return;
+	}
+
+	if ((shutdown_log[0] | (shutdown_log[1] << 8)) != TELEM_LOG_MAGIC ||
+	    shutdown_log[2] != TELEM_LOG_VERSION ||
+	    shutdown_log[3] != TELEM_BLK_SIZE ||
+	    shutdown_log[4] > TELEM_FLUSH_BLKS) {
+		LOG_DBG("No thermal shutdown telemetry");
+		return;
+	}
+
+	/* Header tells how many blocks were saved */
+	size = TELEM_HDR_SIZE + (shutdown_log[4] * TELEM_BLK_SIZE);
+
+	ret = eeprom_read(CONFIG_THERMAL_TELEMETRY_EEPROM_OFFSET +
+			  TELEM_HDR_SIZE, &shutdown_log[TELEM_HDR_SIZE],
+			  size - TELEM_HDR_SIZE);
+	if (ret) {
+		LOG_ERR("Failed to read telemetry %d", ret);
+		return;
+	}
+
+	shutdown_log_valid = true;
+	LOG_WRN("Thermal shutdown telemetry found, %d blocks",
+		shutdown_log[4]);
+}
+
+int thermal_telemetry_read_chunk(uint8_t src, uint16_t chunk, uint8_t *buf)
+{
+	uint32_t ofs = chunk * TELEM_CHUNK_SIZE;
+
+	switch (src) {
+	case TELEM_SRC_LIVE:
+		if (chunk == 0) {
+			telem_latest_view(&live_view, TELEM_BLK_COUNT);
+		}
+
+		for (uint8_t i = 0; i < TELEM_CHUNK_SIZE; i++) {
+			buf[i] = telem_stream_byte(&live_view, ofs + i);
+		}
+		break;
+	case TELEM_SRC_SHUTDOWN:
+		for (uint8_t i = 0; i < TELEM_CHUNK_SIZE; i++, ofs++) {
+			buf[i] = (shutdown_log_valid &&
+				  ofs < sizeof(shutdown_log)) ?
+				 shutdown_log[ofs] : 0xFF;
+		}
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __THERMAL_TELEMETRY_H__
+#define __THERMAL_TELEMETRY_H__
+
+/**
+ * Thermal telemetry history
+ * ------------------------------------------------------
+ * Samples are stored delta-encoded in a RAM ring organized in fixed size
+ * blocks. Each block starts with a 2-byte header followed by records:
+ *
+ *   +--------+--------+----------------------------------------+
+ *   | seq    | used   | records...                             |
+ *   +--------+--------+----------------------------------------+
+ *
+ * seq is a rolling block sequence number, used is the number of bytes
+ * in the block including the header.
+ *
+ * Record header byte, bits 7:6 indicate record type:
+ *  - 00 delta    : bits 5:0 mask of changed fields, followed by one signed
+ *                  byte per changed field in field index order.
+ *  - 01 keyframe : followed by 4 bytes uptime in ms (LE) and all fields,
+ *                  rpm is 2 bytes (LE), other fields 1 byte.
+ *  - 10 event    : bits 5:0 event code.
+ *  - 11 idle     : bits 5:0 number of samples without any change.
+ *
+ * Every block starts with a keyframe so any block can be decoded alone.
+ * Fan rpm deltas are expressed in units of TELEM_RPM_DELTA_UNIT rpm.
+ */
+
+#define TELEM_LOG_MAGIC			0x4C54	/* 'TL' */
+#define TELEM_LOG_VERSION		1u
+
+#define TELEM_REC_DELTA			0x00
+#define TELEM_REC_KEYFRAME		0x40
+#define TELEM_REC_EVENT			0x80
+#define TELEM_REC_IDLE			0xC0
+#define TELEM_REC_TYPE_MASK		0xC0
+#define TELEM_REC_DATA_MASK		0x3F
+
+#define TELEM_RPM_DELTA_UNIT		16u
+
+/* Thermal log sources that can be read by the host */
+#define TELEM_SRC_LIVE			0u
+#define TELEM_SRC_SHUTDOWN		1u
+
+/* Size of each chunk returned to the host per read request */
+#define TELEM_CHUNK_SIZE		8u
+
+enum telem_field {
+	TELEM_FIELD_CPU_TEMP,
+	TELEM_FIELD_GPU_TEMP,
+	TELEM_FIELD_PCH_TEMP,
+	TELEM_FIELD_FAN_DUTY,
+	TELEM_FIELD_FAN_RPM,
+	TELEM_FIELD_FLAGS,
+
+	TELEM_FIELD_TOTAL,
+};
+
+/* Sample flags */
+#define TELEM_FLAG_FAN_OVERRIDE		BIT(0)
+#define TELEM_FLAG_HOST_FAN_CTRL	BIT(1)
+#define TELEM_FLAG_BSOD_OVERRIDE	BIT(2)
+#define TELEM_FLAG_PROCHOT		BIT(3)
+
+enum telem_event {
+	TELEM_EVT_THERM_SHUTDOWN = 1,
+	TELEM_EVT_CPU_TEMP_FAIL,
+	TELEM_EVT_GPU_TEMP_FAIL,
+	TELEM_EVT_PROCHOT_ASSERT,
+	TELEM_EVT_PROCHOT_DEASSERT,
+	TELEM_EVT_CRIT_TEMP_UPDATE,
+};
+
+struct telem_sample {
+	uint8_t cpu_temp;
+	uint8_t gpu_temp;
+	uint8_t pch_temp;
+	uint8_t fan_duty;
+	uint16_t fan_rpm;
+	uint8_t flags;
+};
+
+/**
+ * @brief Initialize thermal telemetry module.
+ *
+ * Loads the telemetry captured during last thermal shutdown from EEPROM.
+ */
+void thermal_telemetry_init(void);
+
+/**
+ * @brief Record a thermal sample.
+ *
+ * This is expected to be called from the thermal management loop, the
+ * sample is only stored every CONFIG_THERMAL_TELEMETRY_DECIMATION calls.
+ *
+ * @param sample pointer to current thermal values.
+ */
+void thermal_telemetry_record(const struct telem_sample *sample);
+
+/**
+ * @brief Record a thermal event.
+ *
+ * @param evt event code.
+ */
+void thermal_telemetry_event(enum telem_event evt);
+
+/**
+ * @brief Store current telemetry in EEPROM.
+ *
+ * EEPROM writes are deferred to a low priority work queue, so EC initiated
+ * thermal shutdown and the system workqueue are not delayed. Intended to be called right before the
+ * shutdown, telemetry must not be recorded afterwards.
+ */
+void thermal_telemetry_flush(void);
+
+/**
+ * @brief Read a chunk of the exported telemetry stream.
+ *
+ * Stream starts with a header (magic, version, block size, block count)
+ * followed by blocks ordered from oldest to newest. Reading chunk 0 latches
+ * the oldest block so following chunks remain consistent while new samples
+ * are recorded; decoder detects overwritten blocks via sequence numbers.
+ *
+ * @param src telemetry source, live ring or last shutdown snapshot.
+ * @param chunk chunk index.
+ * @param buf buffer of TELEM_CHUNK_SIZE bytes.
+ *
+ * @retval -EINVAL if source is invalid.
+ * @retval 0 if success, buffer is filled with 0xFF past end of stream.
+ */
+int thermal_telemetry_read_chunk(uint8_t src, uint16_t chunk, uint8_t *buf);
+
+#endif /* __THERMAL_TELEMETRY_H__ */
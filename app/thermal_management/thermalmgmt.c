@@ -15,14 +15,25 @@
 #include "scicodes.h"
 #include "peci_hub.h"
 #include "pwrplane.h"
+#include "pwrseq_notify.h"
 #include "smchost.h"
 #include "espioob_mngr.h"
 #include "memops.h"
 #include "gpio_ec.h"
+#include "gpio_ec_fast.h"
 #include "task_handler.h"
 #ifdef CONFIG_DTT_SUPPORT_THERMALS
 #include "dtt.h"
 #endif
+#ifdef CONFIG_THERMAL_TELEMETRY
+#include "thermal_telemetry.h"
+#endif
+#ifdef CONFIG_THERMAL_PREDICTIVE_GUARD
+#include "thermal_guard.h"
+#endif
+#ifdef CONFIG_THERMAL_FAN_TACH_MONITOR
+#include "fan_tach.h"
+#endif
 
 LOG_MODULE_REGISTER(thermal, CONFIG_THERMAL_MGMT_LOG_LEVEL);
 
@@ -38,6 +49,9 @@ LOG_MODULE_REGISTER(thermal, CONFIG_THERMAL_MGMT_LOG_LEVEL);
  */
 #define CPU_TEMP_CS_ACCESS_PERIOD_SEC		8U
 
+/* Thermal loop may be delayed this much to share a wakeup with other tasks */
+#define THERMAL_TASK_SLACK_MS			50U
+
 #define CPU_FAIL_SAFE_TEMPERATURE		28U
 
 /* CPU fail critical temperature value is 72C */
@@ -80,6 +94,9 @@ void host_update_crit_temp(uint8_t crit_temp)
 {
 	g_acpi_tbl.acpi_crit_temp = host_req[1] == 0 ?
 		THERM_SHTDWN_THRSD : (host_req[1] + THERM_SHTDWN_EC_TOLERANCE);
+#ifdef CONFIG_THERMAL_TELEMETRY
+	thermal_telemetry_event(TELEM_EVT_CRIT_TEMP_UPDATE);
+#endif
 }
 
 /* Set default BSOD thermal thresholds */
@@ -153,6 +170,10 @@ static void init_fans(void)
 		LOG_ERR("Failed to init fan");
 	}
 
+#ifdef CONFIG_THERMAL_FAN_TACH_MONITOR
+	fan_tach_init(max_fan_dev);
+#endif
+
 	fan_duty_cycle[FAN_CPU] = CONFIG_THERMAL_FAN_OVERRIDE_VALUE;
 	fan_duty_cycle_change = 1;
 }
@@ -227,13 +248,18 @@ static void manage_fan(void)
 	/* Disable power to fan in S5/4/3 and in CS,
 	 * else continue with fan management.
 	 */
-	if ((pwrseq_system_state() != SYSTEM_S0_STATE) ||
-		(smchost_is_system_in_cs())) {
+	if (pwrseq_notify_state() != PWRSEQ_PSTATE_S0) {
 		fan_power_set(false);
+#ifdef CONFIG_THERMAL_FAN_TACH_MONITOR
+		fan_tach_stop();
+#endif
 		return;
 	}
 	/* Enable power to fan when system is in S0 and not in CS */
 	fan_power_set(true);
+#ifdef CONFIG_THERMAL_FAN_TACH_MONITOR
+	fan_tach_start();
+#endif
 
 	if (!is_fan_controlled_by_host()) {
 		/* EC Self control fan based on CPU thermal info */
@@ -262,10 +288,19 @@ static void manage_fan(void)
 	}
 
 	for (uint8_t idx = 0; idx < max_fan_dev; idx++) {
+#ifdef CONFIG_THERMAL_FAN_TACH_MONITOR
+		bool stalled;
+
+		smc_update_fan_tach(idx, fan_tach_get_rpm(idx));
+		if (fan_tach_check_stall(idx, fan_duty_cycle[idx], &stalled)) {
+			smc_update_fan_stall(idx, stalled);
+		}
+#else
 		uint16_t rpm;
 
 		fan_read_rpm(idx, &rpm);
 		smc_update_fan_tach(idx, rpm);
+#endif
 	}
 
 	/* EC assumes OS is hung/BSOD occurred and takes override actions
@@ -328,12 +363,18 @@ void host_set_bios_bsod_override(uint8_t temp_bsod_override_val,
 
 static void manage_cpu_thermal(void)
 {
-	int temp, ret, temp_change;
+	int temp, ret;
+#ifndef CONFIG_THERMAL_PREDICTIVE_GUARD
+	int temp_change;
 	static int prev_notify_temp;
+#endif
 
 	/* Manage CPU thermal only in S0 state */
 	if (!peci_initialized || k_timer_remaining_get(&peci_delay_timer) ||
-	    (pwrseq_system_state() != SYSTEM_S0_STATE)) {
+	    !pwrseq_notify_host_in_s0()) {
+#ifdef CONFIG_THERMAL_PREDICTIVE_GUARD
+		thermal_guard_reset();
+#endif
 		return;
 	}
 
@@ -342,6 +383,9 @@ static void manage_cpu_thermal(void)
 	if (ret) {
 		LOG_ERR("Failed to get cpu temperature, ret-%x", ret);
 		temp = CPU_FAIL_CRITICAL_TEMPERATURE;
+#ifdef CONFIG_THERMAL_TELEMETRY
+		thermal_telemetry_event(TELEM_EVT_CPU_TEMP_FAIL);
+#endif
 	}
 
 	cpu_temp = temp;
@@ -353,17 +397,33 @@ static void manage_cpu_thermal(void)
 	/* Trigger shutdown if temp crosses above critical threshold */
 	if (cpu_temp >= g_acpi_tbl.acpi_crit_temp) {
 		LOG_DBG("EC thermal shutdown");
+#ifdef CONFIG_THERMAL_TELEMETRY
+		thermal_telemetry_event(TELEM_EVT_THERM_SHUTDOWN);
+		/* Saved once shutdown has dropped PWROK */
+		thermal_telemetry_flush();
+#endif
 		therm_shutdown();
 		return;
 	}
 
+#ifdef CONFIG_THERMAL_PREDICTIVE_GUARD
+	/* Failsafe values would distort the temperature slope */
+	if (!ret && thermal_guard_update(cpu_temp,
+					 g_acpi_tbl.acpi_crit_temp)) {
+		enqueue_sci(SCI_THERMAL);
+	}
+#endif
+
 	/* Read GPU temperature using peci if the GPU is in an active state */
-	if ((gpio_read_pin(DG2_PRESENT) == HIGH) &&
-	    (gpio_read_pin(PEG_RTD3_COLD_MOD_SW_R) == HIGH)) {
+	if ((gpio_fast_read_pin(DG2_PRESENT) == HIGH) &&
+	    (gpio_fast_read_pin(PEG_RTD3_COLD_MOD_SW_R) == HIGH)) {
 		ret = peci_get_temp(GPU, &temp);
 		if (ret) {
 			LOG_ERR("Failed to get GPU temperature, ret-%x", ret);
 			temp = GPU_FAIL_CRITICAL_TEMPERATURE;
+#ifdef CONFIG_THERMAL_TELEMETRY
+			thermal_telemetry_event(TELEM_EVT_GPU_TEMP_FAIL);
+#endif
 		}
 
 		/* Update the GPU temperature to acpi offset */
@@ -371,6 +431,7 @@ static void manage_cpu_thermal(void)
 		LOG_WRN("%s: GPU Temp=%d", __func__, temp);
 	}
 
+#ifndef CONFIG_THERMAL_PREDICTIVE_GUARD
 	/* Check temperature change and alert OS */
 	temp_change = cpu_temp - prev_notify_temp;
 
@@ -382,18 +443,22 @@ static void manage_cpu_thermal(void)
 		enqueue_sci(SCI_THERMAL);
 		prev_notify_temp = cpu_temp;
 	}
+#endif
 }
 
-static void manage_pch_temperature(void)
+/* PCH temperature request is issued before the PECI CPU temperature read
+ * and completed after it, hence both transactions are outstanding at the
+ * same time instead of waiting for each other.
+ */
+static uint8_t pchtemp[PCH_TEMP_BUF_SIZE];
+static struct oob_txn *pch_txn;
+
+static void manage_pch_temperature_start(void)
 {
 	static uint8_t temp_poll_cnt = PCH_TEMP_POLLING_CNT_TIME_DIVISION;
 
-	if (pwrseq_system_state() != SYSTEM_S0_STATE) {
-		return;
-	}
-
 	/* Do not fetch PCH temperature in CS */
-	if (smchost_is_system_in_cs()) {
+	if (pwrseq_notify_state() != PWRSEQ_PSTATE_S0) {
 		return;
 	}
 	/* To slow down polling on PCH Temperature, read only once per/sec. */
@@ -403,34 +468,84 @@ static void manage_pch_temperature(void)
 
 	temp_poll_cnt = PCH_TEMP_POLLING_CNT_TIME_DIVISION;
 
-	uint8_t pchtemp[PCH_TEMP_BUF_SIZE] = {
-		OOB_DST_ADDR(OOB_MASTER_ADDR_HW),
-		OOB_CMD_CODE_HW_TEMP,
-		OOB_BYTE_CNT_HW_REQ_MSG,
-		OOB_SRC_ADDR(OOB_SLAVE_ADDR_EC)
-	};
+	pchtemp[0] = OOB_DST_ADDR(OOB_MASTER_ADDR_HW);
+	pchtemp[1] = OOB_CMD_CODE_HW_TEMP;
+	pchtemp[2] = OOB_BYTE_CNT_HW_REQ_MSG;
+	pchtemp[3] = OOB_SRC_ADDR(OOB_SLAVE_ADDR_EC);
 
 	struct espi_oob_packet req = {.buf = pchtemp, .len = 4};
+
+	if (oob_txn_submit(&req, OOB_MSG_SYNC_WAIT_TIME_DFLT, &pch_txn)) {
+		pch_txn = NULL;
+	}
+}
+
+static void manage_pch_temperature_complete(void)
+{
 	struct espi_oob_packet resp = {.buf = pchtemp, .len = sizeof(pchtemp)};
 
-	if (!oob_send_sync(&req, &resp, OOB_MSG_SYNC_WAIT_TIME_DFLT)) {
+	if (pch_txn == NULL) {
+		return;
+	}
+
+	if (!oob_txn_wait(pch_txn, &resp)) {
 		struct oob_msg_str *msg = (struct oob_msg_str *) resp.buf;
 
 		LOG_DBG("PCH Temp = %d", msg->payload[0]);
 		smc_update_pch_dts_temperature(msg->payload[0]);
 	}
+
+	pch_txn = NULL;
 }
 
-void thermalmgmt_handle_cs_exit(void)
+#ifdef CONFIG_THERMAL_TELEMETRY
+static void manage_telemetry(void)
 {
-	LOG_DBG("CS Exit: Wake thermal thread from sleep");
-	/*In CS mode, thread will be in sleep and may take
-	 * up to 'CPU_TEMP_CS_ACCESS_PERIOD_SEC' sec to
-	 * wake up. Hence, this trigger to force wake up
-	 * & avoid delay
+	struct telem_sample sample;
+
+	if (!pwrseq_notify_host_in_s0()) {
+		return;
+	}
+
+	/* Values are taken as reported to the host, this avoids any
+	 * additional sensor access in the thermal loop.
 	 */
-	wake_task((const char *)THRML_MGMT_TASK_NAME);
+	sample.cpu_temp = g_acpi_tbl.acpi_remote_temp;
+	sample.gpu_temp = g_acpi_tbl.acpi_gpu_temp;
+	sample.pch_temp = g_acpi_tbl.acpi_pch_dts_temp;
+	sample.fan_duty = fan_duty_cycle[FAN_CPU];
+	sample.fan_rpm = g_acpi_tbl.acpi_cpu_fan_rpm;
+	sample.flags = 0;
+
+	if (fan_override) {
+		sample.flags |= TELEM_FLAG_FAN_OVERRIDE;
+	}
+
+	if (is_fan_controlled_by_host()) {
+		sample.flags |= TELEM_FLAG_HOST_FAN_CTRL;
+	}
+
+	if (therm_bsod_override_acpi.is_bsod_temp_crossed) {
+		sample.flags |= TELEM_FLAG_BSOD_OVERRIDE;
+	}
+
+#ifdef CONFIG_THERMAL_PREDICTIVE_GUARD
+	if (thermal_guard_is_throttling()) {
+		sample.flags |= TELEM_FLAG_PROCHOT;
+	}
+#endif
+
+	thermal_telemetry_record(&sample);
 }
+#endif
+
+/* Thread is idle in Sx. Any S0/CS entry or exit wakes it up, e.g. CS exit
+ * doesn't wait up to CPU_TEMP_CS_ACCESS_PERIOD_SEC.
+ */
+static EC_TASK_DEFINE(thermal_task, THRML_MGMT_TASK_NAME, 0,
+		      THERMAL_TASK_SLACK_MS,
+		      PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_S0) |
+		      PWRSEQ_PSTATE_MASK(PWRSEQ_PSTATE_S0IX));
 
 void thermalmgmt_thread(void *p1, void *p2, void *p3)
 {
@@ -440,6 +555,9 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 
 	init_fans();
 	init_therm_sensors();
+#ifdef CONFIG_THERMAL_TELEMETRY
+	thermal_telemetry_init();
+#endif
 	err = peci_init();
 	if (!err) {
 		peci_initialized = true;
@@ -449,13 +567,18 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 		/* Each thread is aware of CS
 		 * Thread uses different sleep time during CS
 		 * This required to enter Zephyr-LPM
+		 * Nothing to manage in Sx, fans were turned off on the
+		 * iteration following Sx entry.
 		 */
-		if (smchost_is_system_in_cs()) {
-			k_sleep(K_SECONDS(CPU_TEMP_CS_ACCESS_PERIOD_SEC));
+		if (pwrseq_notify_state() == PWRSEQ_PSTATE_S0IX) {
+			ec_task_set_period(&thermal_task,
+				CPU_TEMP_CS_ACCESS_PERIOD_SEC * MSEC_PER_SEC);
 		} else {
-			k_msleep(normal_period);
+			ec_task_set_period(&thermal_task, normal_period);
 		}
 
+		ec_task_wait(&thermal_task);
+
 		manage_fan();
 
 		/* To achieve infinite C10 residency in connected standby
@@ -463,13 +586,17 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 		 * read commands in CS to avoid SOC wake.
 		 */
 #ifdef CONFIG_PECI_ACCESS_DISABLE_IN_CS
-		if (smchost_is_system_in_cs()) {
+		if (pwrseq_notify_state() == PWRSEQ_PSTATE_S0IX) {
 			continue;
 		}
 #endif
 		manage_thermal_sensors();
+		manage_pch_temperature_start();
 		manage_cpu_thermal();
-		manage_pch_temperature();
+		manage_pch_temperature_complete();
+#ifdef CONFIG_THERMAL_TELEMETRY
+		manage_telemetry();
+#endif
 	}
 }
 
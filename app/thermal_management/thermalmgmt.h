@@ -102,10 +102,4 @@ void peci_start_delay_timer(void);
  */
 void get_hw_peripherals_status(uint8_t *hw_peripherals_sts);
 
-
-/**
- * @brief API for SMC host to notify the CS mode exit.
- *
- */
-void thermalmgmt_handle_cs_exit(void);
 #endif	/* __THERMAL_MGMT_H__ */
@@ -32,6 +32,13 @@ extern uint8_t boot_mode_maf;
 
 #endif /* CONFIG_SOC_FAMILY_MEC */
 
+/* Level driven on PROCHOT to throttle the CPU. PROCHOT# is active low,
+ * boards with a non-inverted PROCHOT output define this as 1.
+ */
+#ifndef PROCHOT_ASSERT_LEVEL
+#define PROCHOT_ASSERT_LEVEL		0
+#endif
+
 #ifdef CONFIG_THERMAL_MANAGEMENT
 #include "thermalmgmt.h"
 #include "board_thermal.h"
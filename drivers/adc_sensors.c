@@ -23,6 +23,49 @@ int16_t adc_temp_val[ADC_CH_TOTAL];
 
 static uint8_t num_of_adc_ch;
 
+#ifdef CONFIG_ADC_SENSORS_CONTINUOUS
+/* Filtered samples kept per channel to compute min/max/slope */
+#define ADC_HIST_SIZE		CONFIG_ADC_SENSORS_HISTORY_SIZE
+#define ADC_HIST_MASK		(ADC_HIST_SIZE - 1)
+
+/* Fractional bits used for the IIR filter state */
+#define ADC_IIR_FRAC_BITS	8u
+
+/* Median filter window, removes single sample spikes */
+#define ADC_MEDIAN_SIZE		3u
+
+BUILD_ASSERT((ADC_HIST_SIZE & ADC_HIST_MASK) == 0,
+	     "ADC history size must be a power of 2");
+
+struct adc_ch_filter {
+	uint16_t median[ADC_MEDIAN_SIZE];
+	uint32_t iir;
+	uint16_t hist[ADC_HIST_SIZE];
+};
+
+static struct adc_ch_filter ch_filter[ADC_CH_TOTAL];
+static uint32_t adc_sample_cnt;
+static struct k_spinlock adc_lock;
+
+/* Sequence is owned by the ADC driver while background sampling runs */
+static int16_t adc_seq_buf[ADC_CH_TOTAL];
+
+static enum adc_action adc_sampling_done(const struct device *dev,
+					 const struct adc_sequence *sequence,
+					 uint16_t sampling_index);
+
+static const struct adc_sequence_options adc_seq_opts = {
+	.interval_us	= CONFIG_ADC_SENSORS_SAMPLING_PERIOD_MS * 1000U,
+	.callback	= adc_sampling_done,
+};
+
+static struct adc_sequence adc_seq = {
+	.options	= &adc_seq_opts,
+	.buffer		= adc_seq_buf,
+	.resolution	= 10,
+};
+#endif
+
 
 static void conv_adc_temp(uint16_t adc_raw_val, int16_t *temperature)
 {
@@ -266,9 +309,155 @@ int adc_sensors_init(uint8_t adc_channel_bits)
 		num_of_adc_ch++;
 	}
 
+#ifdef CONFIG_ADC_SENSORS_CONTINUOUS
+	adc_seq.channels = adc_ch_bits;
+	adc_seq.buffer_size = num_of_adc_ch * sizeof(adc_seq_buf[0]);
+
+	/* Sampling is repeated by the driver from its own timer, the
+	 * sequence never completes so no completion signal is needed.
+	 */
+	ret = adc_read_async(adc_dev, &adc_seq, NULL);
+	if (ret) {
+		LOG_ERR("Failed to start ADC background sampling %d", ret);
+	}
+#endif
+
 	return ret;
 }
 
+#ifdef CONFIG_ADC_SENSORS_CONTINUOUS
+static uint16_t median3(const uint16_t *val)
+{
+	uint16_t a = val[0], b = val[1], c = val[2];
+
+	if (a > b) {
+		uint16_t tmp = a;
+
+		a = b;
+		b = tmp;
+	}
+
+	/* a <= b, median is b bounded by [a, c] */
+	if (c < b) {
+		b = (c > a) ? c : a;
+	}
+
+	return b;
+}
+
+static void adc_filter_sample(struct adc_ch_filter *flt, uint16_t raw,
+			      uint32_t idx)
+{
+	uint32_t target;
+
+	if (idx == 0) {
+		/* Seed the filter with the first sample */
+		for (uint8_t i = 0; i < ADC_MEDIAN_SIZE; i++) {
+			flt->median[i] = raw;
+		}
+
+		flt->iir = (uint32_t)raw << ADC_IIR_FRAC_BITS;
+	}
+
+	flt->median[idx % ADC_MEDIAN_SIZE] = raw;
+	target = (uint32_t)median3(flt->median) << ADC_IIR_FRAC_BITS;
+
+	/* Single pole low pass: y += (x - y) / 2^shift */
+	if (target >= flt->iir) {
+		flt->iir += (target - flt->iir) >>
+			    CONFIG_ADC_SENSORS_IIR_SHIFT;
+	} else {
+		flt->iir -= (flt->iir - target) >>
+			    CONFIG_ADC_SENSORS_IIR_SHIFT;
+	}
+
+	flt->hist[idx & ADC_HIST_MASK] = flt->iir >> ADC_IIR_FRAC_BITS;
+}
+
+/* Called from ADC ISR context every sampling period */
+static enum adc_action adc_sampling_done(const struct device *dev,
+					 const struct adc_sequence *sequence,
+					 uint16_t sampling_index)
+{
+	k_spinlock_key_t key = k_spin_lock(&adc_lock);
+	uint8_t ch_cnt = 0;
+
+	for (uint8_t ch = ADC_CH_00; ch < ADC_CH_TOTAL; ch++) {
+		if (adc_ch_bits & BIT(ch)) {
+			adc_filter_sample(&ch_filter[ch],
+					  adc_seq_buf[ch_cnt++],
+					  adc_sample_cnt);
+		}
+	}
+
+	adc_sample_cnt++;
+	k_spin_unlock(&adc_lock, key);
+
+	return ADC_ACTION_REPEAT;
+}
+
+int adc_sensors_get_stats(uint8_t adc_ch, struct adc_sensor_stats *stats)
+{
+	struct adc_ch_filter flt;
+	uint32_t cnt, n, oldest;
+	uint16_t raw_min = UINT16_MAX;
+	uint16_t raw_max = 0;
+	int16_t t_new, t_old;
+	k_spinlock_key_t key;
+
+	if (adc_ch >= ADC_CH_TOTAL || !(adc_ch_bits & BIT(adc_ch))) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&adc_lock);
+	flt = ch_filter[adc_ch];
+	cnt = adc_sample_cnt;
+	k_spin_unlock(&adc_lock, key);
+
+	if (cnt == 0) {
+		return -EAGAIN;
+	}
+
+	n = MIN(cnt, ADC_HIST_SIZE);
+	oldest = cnt - n;
+
+	for (uint32_t i = 0; i < n; i++) {
+		uint16_t raw = flt.hist[(oldest + i) & ADC_HIST_MASK];
+
+		raw_min = MIN(raw_min, raw);
+		raw_max = MAX(raw_max, raw);
+	}
+
+	/* Keep last converted value if raw reading is out of table range */
+	stats->temp = adc_temp_val[adc_ch];
+	conv_adc_temp(flt.iir >> ADC_IIR_FRAC_BITS, &stats->temp);
+
+	/* Thermistor is NTC, higher raw value means lower temperature */
+	stats->min_temp = stats->temp;
+	stats->max_temp = stats->temp;
+	conv_adc_temp(raw_max, &stats->min_temp);
+	conv_adc_temp(raw_min, &stats->max_temp);
+
+	stats->slope = 0;
+	if (n > 1) {
+		t_new = stats->temp;
+		t_old = stats->temp;
+		conv_adc_temp(flt.hist[(cnt - 1) & ADC_HIST_MASK], &t_new);
+		conv_adc_temp(flt.hist[oldest & ADC_HIST_MASK], &t_old);
+		stats->slope = ((int32_t)(t_new - t_old) * MSEC_PER_SEC) /
+			       (int32_t)((n - 1) *
+				CONFIG_ADC_SENSORS_SAMPLING_PERIOD_MS);
+	}
+
+	return 0;
+}
+#else
+int adc_sensors_get_stats(uint8_t adc_ch, struct adc_sensor_stats *stats)
+{
+	return -ENOTSUP;
+}
+#endif
+
 
 void adc_sensors_read_all(void)
 {
@@ -277,6 +466,18 @@ void adc_sensors_read_all(void)
 		return;
 	}
 
+#ifdef CONFIG_ADC_SENSORS_CONTINUOUS
+	struct adc_sensor_stats stats;
+
+	/* Publish latest filtered values, no ADC access is performed */
+	for (uint8_t ch = ADC_CH_00; ch < ADC_CH_TOTAL; ch++) {
+		if (!adc_sensors_get_stats(ch, &stats)) {
+			adc_temp_val[ch] = stats.temp;
+		}
+
+		LOG_DBG("ADC Ch %d : %d", ch, adc_temp_val[ch]);
+	}
+#else
 	int ret;
 	int16_t adc_raw_val[num_of_adc_ch];
 	uint8_t ch, ch_cnt = 0;
@@ -301,5 +502,5 @@ void adc_sensors_read_all(void)
 
 		LOG_DBG("ADC Ch %d : %d", ch, adc_temp_val[ch]);
 	}
+#endif
 }
-
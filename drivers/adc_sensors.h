@@ -23,6 +23,20 @@ enum adc_ch_num {
 
 extern int16_t adc_temp_val[ADC_CH_TOTAL];
 
+/**
+ * @brief Filtered reading and statistics for an ADC thermal sensor.
+ *
+ * Temperatures are in order of magnitude 10 degree celsius, same as
+ * adc_temp_val. Min, max and slope are computed over the sample history
+ * window, slope is expressed in 0.1 degree celsius per second.
+ */
+struct adc_sensor_stats {
+	int16_t temp;
+	int16_t min_temp;
+	int16_t max_temp;
+	int16_t slope;
+};
+
 /**
  * @brief Initialize thermal sensor module.
  *
@@ -41,4 +55,21 @@ int adc_sensors_init(uint8_t adc_channel_bits);
  */
 void adc_sensors_read_all(void);
 
+/**
+ * @brief Get filtered reading and statistics for an ADC channel.
+ *
+ * Only available when background acquisition is enabled. The values are
+ * taken from a consistent snapshot of the channel filter state and the
+ * call never waits for an ADC conversion.
+ *
+ * @param adc_ch ADC channel number.
+ * @param stats pointer to the statistics to be updated.
+ *
+ * @retval -ENOTSUP if background acquisition is not enabled.
+ * @retval -EINVAL if channel is not enabled.
+ * @retval -EAGAIN if no sample has been acquired yet.
+ * @retval 0 if success.
+ */
+int adc_sensors_get_stats(uint8_t adc_ch, struct adc_sensor_stats *stats);
+
 #endif	/* __ADC_SENSORS_H__ */
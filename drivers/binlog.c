@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <device.h>
+#include <drivers/uart.h>
+#include <sys/byteorder.h>
+#include <logging/log_backend.h>
+#include <logging/log_backend_std.h>
+#include <logging/log_output.h>
+#include <logging/log_output_dict.h>
+#include "emi.h"
+#include "binlog.h"
+
+#define RING_SIZE		CONFIG_BINLOG_SIZE
+#define RING_MASK		(RING_SIZE - 1U)
+#define REC_HDR_SIZE		2U
+#define REC_MAX			CONFIG_BINLOG_RECORD_MAX
+#define DUMP_LINE		32U
+#define DUMP_STACK_SIZE		512
+
+BUILD_ASSERT((RING_SIZE & RING_MASK) == 0,
+	     "Binary log size must be a power of 2");
+BUILD_ASSERT(REC_HDR_SIZE + REC_MAX <= RING_SIZE,
+	     "Binary log message exceeds ring size");
+
+struct __packed binlog_ring {
+	struct binlog_hdr hdr;
+	uint8_t data[RING_SIZE];
+};
+
+BUILD_ASSERT(sizeof(struct binlog_ring) + sizeof(emi_dir_t) <=
+	     CONFIG_EMI_ARENA_SIZE, "Binary log exceeds EMI arena");
+
+/* Allocated in EMI arena, exposed as is to the host */
+static struct binlog_ring *ring;
+static emi_block_t ring_blk;
+
+/* Messages are stored from log thread, or from caller context once
+ * logging is in panic mode, ring is also read from SMC host thread.
+ */
+static struct k_spinlock lock;
+
+/* Message being formatted, stored in ring once complete */
+static uint8_t rec[REC_MAX];
+static uint16_t rec_len;
+static bool rec_trunc;
+
+/* Header snapshot taken when host starts reading */
+static struct binlog_hdr snap;
+
+#ifdef CONFIG_UART_CONSOLE
+/* Polled UART dump takes hundreds of ms, only run when nothing else does */
+static K_THREAD_STACK_DEFINE(dump_stack, DUMP_STACK_SIZE);
+static struct k_work_q dump_queue;
+
+static void dump_handler(struct k_work *work);
+static K_WORK_DEFINE(dump_work, dump_handler);
+#endif
+
+static int rec_out(uint8_t *data, size_t length, void *ctx)
+{
+	size_t len = MIN(length, REC_MAX - rec_len);
+
+	ARG_UNUSED(ctx);
+
+	memcpy(&rec[rec_len], data, len);
+	rec_len += len;
+	if (len < length) {
+		rec_trunc = true;
+	}
+
+	return length;
+}
+
+static uint8_t out_buf[16];
+LOG_OUTPUT_DEFINE(binlog_output, rec_out, out_buf, sizeof(out_buf));
+
+static void ring_copy(uint32_t pos, const uint8_t *data, uint16_t len)
+{
+	for (uint16_t i = 0; i < len; i++) {
+		ring->data[(pos + i) & RING_MASK] = data[i];
+	}
+}
+
+static uint16_t ring_get_le16(uint32_t pos)
+{
+	return ring->data[pos & RING_MASK] |
+	       (ring->data[(pos + 1) & RING_MASK] << 8);
+}
+
+static void rec_commit(void)
+{
+	uint32_t need = REC_HDR_SIZE + rec_len;
+	uint8_t len_le[REC_HDR_SIZE];
+
+	emi_block_update_begin(&ring_blk);
+
+	/* Drop oldest records, tail always stays on a record start */
+	while (ring->hdr.head + need - ring->hdr.tail > RING_SIZE) {
+		ring->hdr.tail += REC_HDR_SIZE + ring_get_le16(ring->hdr.tail);
+	}
+
+	sys_put_le16(rec_len, len_le);
+	ring_copy(ring->hdr.head, len_le, REC_HDR_SIZE);
+	ring_copy(ring->hdr.head + REC_HDR_SIZE, rec, rec_len);
+	ring->hdr.head += need;
+
+	emi_block_update_end(&ring_blk);
+}
+
+/* A message too long for a record is replaced by a dropped message, so the
+ * host decoder stays in sync.
+ */
+static void rec_store(void)
+{
+	if (rec_trunc) {
+		rec_len = 0;
+		rec_trunc = false;
+		log_dict_output_dropped_process(&binlog_output, 1);
+	}
+
+	if (rec_len) {
+		rec_commit();
+	}
+}
+
+static void process(const struct log_backend *const backend,
+		    union log_msg2_generic *msg)
+{
+	k_spinlock_key_t key;
+
+	if (ring == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	rec_len = 0;
+	rec_trunc = false;
+	log_dict_output_msg2_process(&binlog_output, &msg->log, 0);
+	rec_store();
+	k_spin_unlock(&lock, key);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	k_spinlock_key_t key;
+
+	if (ring == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	rec_len = 0;
+	rec_trunc = false;
+	log_dict_output_dropped_process(&binlog_output, cnt);
+	rec_store();
+	k_spin_unlock(&lock, key);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+	/* Ring is written synchronously, nothing to switch */
+	log_backend_std_panic(&binlog_output);
+}
+
+static void binlog_init(const struct log_backend *const backend)
+{
+	if (emi_block_publish(&ring_blk, EMI_BLOCK_LOG, BINLOG_VERSION,
+			      sizeof(*ring)) != EMI_SUCCESS) {
+		/* Backend can't log about itself, host sees no log block */
+		return;
+	}
+
+	ring = ring_blk.data;
+	ring->hdr.magic = BINLOG_MAGIC;
+	ring->hdr.version = BINLOG_VERSION;
+	ring->hdr.size = RING_SIZE;
+	emi_block_update_end(&ring_blk);
+
+#ifdef CONFIG_UART_CONSOLE
+	k_work_queue_start(&dump_queue, dump_stack,
+			   K_THREAD_STACK_SIZEOF(dump_stack),
+			   K_LOWEST_APPLICATION_THREAD_PRIO, NULL);
+#endif
+}
+
+static const struct log_backend_api binlog_api = {
+	.process = process,
+	.dropped = dropped,
+	.panic = panic,
+	.init = binlog_init,
+};
+
+LOG_BACKEND_DEFINE(binlog_backend, binlog_api, true);
+
+/* Must be called with lock held */
+static uint8_t stream_byte(uint32_t ofs)
+{
+	uint32_t pos;
+
+	if (ring == NULL) {
+		return 0xFF;
+	}
+
+	if (ofs < sizeof(snap)) {
+		return ((const uint8_t *)&snap)[ofs];
+	}
+
+	/* Past end of snapshot or overwritten since */
+	pos = snap.tail + (ofs - sizeof(snap));
+	if (pos - snap.tail >= snap.head - snap.tail ||
+	    ring->hdr.head - pos > RING_SIZE) {
+		return 0xFF;
+	}
+
+	return ring->data[pos & RING_MASK];
+}
+
+void binlog_read_chunk(uint16_t chunk, uint8_t *buf)
+{
+	uint32_t ofs = chunk * BINLOG_CHUNK_SIZE;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (chunk == 0 && ring) {
+		snap = ring->hdr;
+	}
+
+	for (uint8_t i = 0; i < BINLOG_CHUNK_SIZE; i++) {
+		buf[i] = stream_byte(ofs + i);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+#ifdef CONFIG_UART_CONSOLE
+static void dump_handler(struct k_work *work)
+{
+	static const char hex[] = "0123456789abcdef";
+	const struct device *uart;
+	const char *prefix = "binlog:";
+	uint8_t line[DUMP_LINE];
+	uint32_t len, count;
+	k_spinlock_key_t key;
+
+	uart = device_get_binding(CONFIG_UART_CONSOLE_ON_DEV_NAME);
+	if (uart == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+	if (ring == NULL) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+	snap = ring->hdr;
+	len = sizeof(snap) + snap.head - snap.tail;
+	k_spin_unlock(&lock, key);
+
+	/* Lock is only held per line, logging goes on while dumping */
+	for (uint32_t ofs = 0; ofs < len; ofs += DUMP_LINE) {
+		count = MIN(DUMP_LINE, len - ofs);
+
+		key = k_spin_lock(&lock);
+		for (uint32_t i = 0; i < count; i++) {
+			line[i] = stream_byte(ofs + i);
+		}
+		k_spin_unlock(&lock, key);
+
+		for (const char *c = prefix; *c; c++) {
+			uart_poll_out(uart, *c);
+		}
+
+		for (uint32_t i = 0; i < count; i++) {
+			uart_poll_out(uart, hex[line[i] >> 4]);
+			uart_poll_out(uart, hex[line[i] & 0xF]);
+		}
+
+		uart_poll_out(uart, '\r');
+		uart_poll_out(uart, '\n');
+	}
+}
+#endif
+
+void binlog_dump_request(void)
+{
+#ifdef CONFIG_UART_CONSOLE
+	if (ring) {
+		k_work_submit_to_queue(&dump_queue, &dump_work);
+	}
+#endif
+}
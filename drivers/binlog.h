@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Binary log ring backend.
+ *
+ * Log messages are stored in Zephyr dictionary format: a format string
+ * address and the raw arguments, no formatting is done by the EC. Messages
+ * are kept in a RAM ring, the oldest messages are dropped once full. The
+ * ring is exposed over EMI and read by the host through SMC host command or
+ * UART dump, tools/binlog decodes it with the strings from the EC FW ELF.
+ *
+ * Ring: header | data, data holds records len (2) | message (len).
+ *
+ * Header head and tail count bytes written since boot, data between tail and
+ * head modulo ring size holds the records, tail is always a record start.
+ */
+
+#ifndef __BINLOG_H__
+#define __BINLOG_H__
+
+#include <zephyr.h>
+
+#define BINLOG_MAGIC		0x4C42
+#define BINLOG_VERSION		1
+
+/* SMC read chunk size */
+#define BINLOG_CHUNK_SIZE	8U
+
+/**
+ * @brief Ring header, followed by ring data.
+ */
+struct __packed binlog_hdr {
+	uint16_t magic;
+	uint8_t version;
+	uint8_t rsvd;
+	/* Ring data size in bytes, power of 2 */
+	uint16_t size;
+	uint16_t rsvd2;
+	uint32_t head;
+	uint32_t tail;
+};
+
+/**
+ * @brief Read a chunk of the binary log.
+ *
+ * Log is read as a stream: header, then ring data from tail to head. Chunk
+ * 0 takes a snapshot of the header, next chunks return ring data of that
+ * snapshot. Bytes overwritten since the snapshot and bytes past the end are
+ * returned as 0xFF. Host reads chunk 0 again once done, records before the
+ * new tail are not valid.
+ *
+ * @param chunk chunk index.
+ * @param buf buffer of BINLOG_CHUNK_SIZE bytes.
+ */
+void binlog_read_chunk(uint16_t chunk, uint8_t *buf);
+
+/**
+ * @brief Request a dump of the binary log to the console UART.
+ *
+ * Same stream as binlog_read_chunk(), as hex lines prefixed with "binlog:".
+ * Dump is done by a low priority preemptible thread, so the caller and EC
+ * tasks are not held while the UART is polled.
+ *
+ * @note Can be called from ISR.
+ */
+void binlog_dump_request(void);
+
+#endif /* __BINLOG_H__ */
@@ -16,143 +16,195 @@ LOG_MODULE_REGISTER(eeprom, CONFIG_EEPROM_LOG_LEVEL);
 
 /* LAN enable/disable status */
 #define EEPROM_LANSTS               0x00
-/* EEPROM write delay 5ms */
-#define EEPROM_WR_MSDELAY           5
 
 #define EEPROM_DEFAULT_DATA         0xFFu
-#define DATA_MAX_LEN                31
+#define EEPROM_BLOCK_SIZE           256u
+#define EEPROM_PAGE_SIZE            CONFIG_EEPROM_PAGE_SIZE
 
 #define OFS_MSB(word)  (((word & 0xFF00) >> 8))
 #define OFS_LSB(word)  (word & 0xFF)
 
+BUILD_ASSERT((EEPROM_BLOCK_SIZE % EEPROM_PAGE_SIZE) == 0,
+	     "EEPROM pages must not cross a block boundary");
+
+/* EEPROM is shared by several tasks, an access during a write cycle would
+ * not be acknowledged.
+ */
+K_MUTEX_DEFINE(eeprom_mutex);
+
 /* EEPROM access for offset greater than 255.
  * Following the 4-bit device type identifier in the bits 3-1 of the device
  * slave address byte are bits A10, A9 and A8 which are the three MSB of the
  * memory array word address
  * i.e. offset 0x0006 correspond to device address 0x50, offset 0x06
  * i.e. offset 0x0106 correspond to device address 0x51, offset 0x00
+ *
+ * Sequential reads wrap around within a block, so transfers are split at
+ * block boundaries. Writes are split at page boundaries, as page writes
+ * wrap around within a page.
  */
 
-int eeprom_read_byte(uint16_t offset, uint8_t *data)
+static int eeprom_check_range(uint16_t offset, size_t len)
 {
-	uint8_t ret;
-	uint8_t buf = OFS_LSB(offset);
-
-	ret = i2c_hub_write_read(I2C_0,
-			     EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset),
-			     &buf, sizeof(buf),
-			     data, 1);
-	if (ret) {
-		LOG_ERR("Fail to read: %d", ret);
-		return ret;
+	if (offset >= CONFIG_EEPROM_SIZE ||
+	    len > (CONFIG_EEPROM_SIZE - offset)) {
+		return -EINVAL;
 	}
 
 	return 0;
 }
 
-int eeprom_write_byte(uint16_t offset, uint8_t data)
+/* EEPROM does not acknowledge its address until the internal write cycle
+ * completes, poll it rather than waiting for worst case write time.
+ */
+static int eeprom_wait_write_done(uint16_t offset)
 {
-	uint8_t ret;
-	uint8_t buf[] = { OFS_LSB(offset), data };
+	int64_t deadline = k_uptime_ticks() +
+			   k_ms_to_ticks_ceil64(CONFIG_EEPROM_WRITE_TIMEOUT_MS);
+	uint8_t dummy;
 
-	ret = i2c_hub_write(I2C_0, buf, sizeof(buf),
-			EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset));
-	if (ret) {
-		LOG_ERR("Fail to write: %d", ret);
-		return ret;
-	}
+	do {
+		k_usleep(CONFIG_EEPROM_ACK_POLL_US);
 
-	k_msleep(EEPROM_WR_MSDELAY);
+		if (!i2c_hub_read(I2C_0, &dummy, sizeof(dummy),
+				  EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset))) {
+			return 0;
+		}
+	} while (k_uptime_ticks() < deadline);
 
-	return 0;
+	LOG_ERR("Write cycle timeout at %x", offset);
+	return -ETIMEDOUT;
 }
 
-int eeprom_read_word(uint16_t offset, uint16_t *data)
+static int eeprom_write_page(uint16_t offset, const uint8_t *data,
+			     uint16_t len)
 {
-	uint8_t ret;
-	uint8_t buf = { OFS_LSB(offset) };
-	uint8_t rbuf[] = {EEPROM_DEFAULT_DATA, EEPROM_DEFAULT_DATA};
+	int ret;
+	uint8_t buf[EEPROM_PAGE_SIZE + 1];
 
-	ret = i2c_hub_write_read(I2C_0,
-			     EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset),
-			     &buf, sizeof(buf),
-			     rbuf, sizeof(rbuf));
+	buf[0] = OFS_LSB(offset);
+	ret = memcpys(&buf[1], data, len);
 	if (ret) {
-		LOG_ERR("Fail to read: %d", ret);
+		LOG_ERR("Fail during buffer copy: %d", ret);
 		return ret;
 	}
 
-	/* Adjust endianness */
-	*data = ((rbuf[0] << 8) | rbuf[1]);
+	ret = i2c_hub_write(I2C_0, buf, len + 1,
+			    EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset));
+	if (ret) {
+		LOG_ERR("Fail to write: %d", ret);
+		return ret;
+	}
 
-	return 0;
+	return eeprom_wait_write_done(offset);
 }
 
-int eeprom_write_word(uint16_t offset, uint16_t data)
+int eeprom_read(uint16_t offset, uint8_t *data, size_t len)
 {
-	uint16_t ret;
-	uint8_t buf[] = { OFS_LSB(offset),
-		       OFS_MSB(data), OFS_LSB(data) };
+	int ret;
+	uint16_t chunk;
+	uint8_t buf;
 
-	ret = i2c_hub_write(I2C_0, buf, sizeof(buf),
-			EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset));
+	ret = eeprom_check_range(offset, len);
 	if (ret) {
-		LOG_ERR("Fail to write: %d", ret);
 		return ret;
 	}
 
-	/* Delay to wait for write completion */
-	k_msleep(EEPROM_WR_MSDELAY);
+	k_mutex_lock(&eeprom_mutex, K_FOREVER);
 
-	return 0;
-}
+	while (len) {
+		chunk = MIN(len, EEPROM_BLOCK_SIZE - OFS_LSB(offset));
+		buf = OFS_LSB(offset);
 
-int eeprom_read_block(uint16_t offset, uint8_t len, uint8_t *data)
-{
-	uint16_t ret;
-	uint8_t buf = { OFS_LSB(offset) };
+		ret = i2c_hub_write_read(I2C_0,
+				EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset),
+				&buf, sizeof(buf), data, chunk);
+		if (ret) {
+			LOG_ERR("Fail to read: %d", ret);
+			ret = -EIO;
+			break;
+		}
 
-	if (len > DATA_MAX_LEN) {
-		return -EINVAL;
+		offset += chunk;
+		data += chunk;
+		len -= chunk;
 	}
 
-	ret = i2c_hub_write_read(I2C_0,
-			     EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset),
-			     &buf, sizeof(buf),
-			     data, len);
-	if (ret) {
-		LOG_ERR("Fail to read: %d", ret);
-		return -EIO;
-	}
+	k_mutex_unlock(&eeprom_mutex);
 
 	return ret;
 }
 
-int eeprom_write_block(uint16_t offset, uint8_t len, uint8_t *data)
+int eeprom_write(uint16_t offset, const uint8_t *data, size_t len)
 {
 	int ret;
-	uint8_t buf[DATA_MAX_LEN + sizeof(offset)];
+	uint16_t chunk;
 
-	if (len > DATA_MAX_LEN) {
-		return -EINVAL;
+	ret = eeprom_check_range(offset, len);
+	if (ret) {
+		return ret;
 	}
 
-	buf[0] = OFS_LSB(offset);
-	ret = memcpys(&buf[1], data, len);
+	k_mutex_lock(&eeprom_mutex, K_FOREVER);
 
-	if (ret) {
-		LOG_ERR("Fail during buffer copy: %d", ret);
-		return ret;
+	while (len) {
+		chunk = MIN(len, EEPROM_PAGE_SIZE -
+				 (offset % EEPROM_PAGE_SIZE));
+
+		ret = eeprom_write_page(offset, data, chunk);
+		if (ret) {
+			break;
+		}
+
+		offset += chunk;
+		data += chunk;
+		len -= chunk;
 	}
 
-	ret = i2c_hub_write(I2C_0, buf, len + sizeof(offset),
-			EEPROM_DRIVER_I2C_ADDR | OFS_MSB(offset));
+	k_mutex_unlock(&eeprom_mutex);
+
+	return ret;
+}
+
+int eeprom_read_byte(uint16_t offset, uint8_t *data)
+{
+	return eeprom_read(offset, data, sizeof(*data));
+}
+
+int eeprom_write_byte(uint16_t offset, uint8_t data)
+{
+	return eeprom_write(offset, &data, sizeof(data));
+}
+
+int eeprom_read_word(uint16_t offset, uint16_t *data)
+{
+	int ret;
+	uint8_t rbuf[] = {EEPROM_DEFAULT_DATA, EEPROM_DEFAULT_DATA};
+
+	ret = eeprom_read(offset, rbuf, sizeof(rbuf));
 	if (ret) {
-		LOG_ERR("Fail to write: %d", ret);
 		return ret;
 	}
 
-	k_msleep(EEPROM_WR_MSDELAY);
+	/* Adjust endianness */
+	*data = ((rbuf[0] << 8) | rbuf[1]);
 
-	return ret;
+	return 0;
+}
+
+int eeprom_write_word(uint16_t offset, uint16_t data)
+{
+	uint8_t buf[] = { OFS_MSB(data), OFS_LSB(data) };
+
+	return eeprom_write(offset, buf, sizeof(buf));
+}
+
+int eeprom_read_block(uint16_t offset, uint8_t len, uint8_t *data)
+{
+	return eeprom_read(offset, data, len);
+}
+
+int eeprom_write_block(uint16_t offset, uint8_t len, uint8_t *data)
+{
+	return eeprom_write(offset, data, len);
 }
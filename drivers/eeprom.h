@@ -12,6 +12,33 @@
 #ifndef __EEPROM_H__
 #define __EEPROM_H__
 
+/**
+ * @brief Read any amount of bytes from given offset.
+ *
+ * Reads are sequential, a single transaction is used per 256 bytes block.
+ *
+ * @param offset to read from EEPROM.
+ * @param data pointer where data will be copied.
+ * @param len the amount of bytes to read.
+ *
+ * @retval 0 if success, error otherwise.
+ */
+int eeprom_read(uint16_t offset, uint8_t *data, size_t len);
+
+/**
+ * @brief Write any amount of bytes to given offset.
+ *
+ * Data is written one page per transaction. Returns once the last write
+ * cycle has completed.
+ *
+ * @param offset from EEPROM to perform write.
+ * @param data pointer to the information to write in EEPROM.
+ * @param len the amount of bytes to write.
+ *
+ * @retval 0 if success, error otherwise.
+ */
+int eeprom_write(uint16_t offset, const uint8_t *data, size_t len);
+
 /**
  * @brief Read a byte from a EEPROM offset.
  *
@@ -1,14 +1,36 @@
 /* Embedded Memory Interface (EMI) Driver */
 
 #include <zephyr.h>
+#include <string.h>
+#include <soc.h>
 #include "emi.h"
 
 #define EC_EMI_0_BASE 0x400f4000
 #define EC_EMI_1_BASE 0x400f4400
 
+#define EMI_ARENA_REGION EMI_REGION_1
+
+BUILD_ASSERT(CONFIG_EMI_ARENA_SIZE % sizeof(uint32_t) == 0,
+             "EMI regions have DWORD granularity");
+BUILD_ASSERT(sizeof(emi_dir_t) < CONFIG_EMI_ARENA_SIZE,
+             "EMI arena too small for directory");
+
+/* arena is exposed as is, directory first, then blocks */
+static uint8_t emi_arena[CONFIG_EMI_ARENA_SIZE] __aligned(4);
+static emi_dir_t *const emi_dir = (emi_dir_t *) emi_arena;
+static uint16_t emi_arena_used;
+static bool emi_arena_ready;
+
+/* blocks are published from several tasks */
+K_MUTEX_DEFINE(emi_block_mutex);
+
 /* <--- Forward Declaration of internal Functionality ---> */
 
 static emi_config_space_t* emi_config_space(const EMI_INSTANCE instance);
+static int emi_arena_init(void);
+static emi_block_desc_t* emi_block_add(const EMI_BLOCK_TYPE type, uint8_t version,
+                                       const EMI_REGION region, uint16_t offset,
+                                       uint16_t size);
 
 /* <--- Exposed Functionality ---> */
 
@@ -78,8 +100,148 @@ void emi_reset_config(emi_t *emi) {
     emi->config->host_clear_enable_register &= 0x1;
 }
 
+int emi_block_publish(emi_block_t *blk, const EMI_BLOCK_TYPE type,
+                      uint8_t version, uint16_t size) {
+
+    uint16_t offset;
+    int ret = EMI_FAILURE;
+
+    k_mutex_lock(&emi_block_mutex, K_FOREVER);
+
+    if(emi_arena_init() != EMI_SUCCESS)
+        goto out;
+
+    offset = emi_arena_used;
+    if(size > CONFIG_EMI_ARENA_SIZE - offset)
+        goto out;
+
+    blk->data = &emi_arena[offset];
+    memset(blk->data, 0, size);
+
+    blk->desc = emi_block_add(type, version, EMI_ARENA_REGION, offset, size);
+    if(blk->desc == NULL)
+        goto out;
+
+    emi_arena_used = ROUND_UP(offset + size, sizeof(uint32_t));
+    ret = EMI_SUCCESS;
+
+out:
+    k_mutex_unlock(&emi_block_mutex);
+    return ret;
+}
+
+int emi_block_publish_region(emi_block_t *blk, const EMI_BLOCK_TYPE type,
+                             uint8_t version, const EMI_REGION region,
+                             void *data, uint16_t size) {
+
+    emi_t emi;
+    int ret = EMI_FAILURE;
+
+    /*
+     * Ensure EMI region base and size are aligned to a DWORD
+     * boundary, as the registers only have DWORD granularity.
+     * */
+    emi_region_config_t rconf = {
+        .base        = (uint32_t)(uintptr_t) data,
+        .read_limit  = ROUND_UP(size, sizeof(uint32_t)),
+        .write_limit = 0
+    };
+
+    if(region == EMI_ARENA_REGION || ((uintptr_t) data & 0x3))
+        return EMI_FAILURE;
+
+    k_mutex_lock(&emi_block_mutex, K_FOREVER);
+
+    if(emi_arena_init() != EMI_SUCCESS ||
+       emi_get(&emi, EMI_INSTANCE_0) != EMI_SUCCESS ||
+       emi_configure_region(&emi, region, &rconf) != EMI_SUCCESS)
+        goto out;
+
+    blk->data = data;
+    blk->desc = emi_block_add(type, version, region, 0, size);
+    if(blk->desc != NULL)
+        ret = EMI_SUCCESS;
+
+out:
+    k_mutex_unlock(&emi_block_mutex);
+    return ret;
+}
+
+void emi_block_update_begin(emi_block_t *blk) {
+
+    /* odd generation, host retries until update ends */
+    blk->desc->generation |= 0x1;
+    __DMB();
+}
+
+void emi_block_update_end(emi_block_t *blk) {
+
+    /* data must be visible before the generation, never 0 once ready */
+    __DMB();
+    blk->desc->generation = (blk->desc->generation | 0x1) + 1;
+}
+
 /* <--- Internal Functionality ---> */
 
+/*
+ * emi_arena_init - expose the arena directory through the arena region once
+ * =>         returns EMI_SUCCESS on success and EMI_FAILURE on failure
+ * */
+static int emi_arena_init(void) {
+
+    emi_t emi;
+    emi_region_config_t rconf = {
+        .base        = (uint32_t)(uintptr_t) emi_arena,
+        .read_limit  = CONFIG_EMI_ARENA_SIZE,
+        .write_limit = 0
+    };
+
+    if(emi_arena_ready)
+        return EMI_SUCCESS;
+
+    emi_dir->magic   = EMI_DIR_MAGIC;
+    emi_dir->version = EMI_DIR_VERSION;
+    emi_dir->count   = 0;
+    emi_dir->size    = CONFIG_EMI_ARENA_SIZE;
+    emi_arena_used   = ROUND_UP(sizeof(emi_dir_t), sizeof(uint32_t));
+
+    if(emi_get(&emi, EMI_INSTANCE_0) != EMI_SUCCESS ||
+       emi_configure_region(&emi, EMI_ARENA_REGION, &rconf) != EMI_SUCCESS)
+        return EMI_FAILURE;
+
+    emi_arena_ready = true;
+    return EMI_SUCCESS;
+}
+
+/*
+ * emi_block_add - fill in next free descriptor, then make it visible
+ * =>         returns the descriptor and NULL if the directory is full
+ * */
+static emi_block_desc_t* emi_block_add(const EMI_BLOCK_TYPE type, uint8_t version,
+                                       const EMI_REGION region, uint16_t offset,
+                                       uint16_t size) {
+
+    emi_block_desc_t *desc;
+
+    if(emi_dir->count >= CONFIG_EMI_MAX_BLOCKS)
+        return NULL;
+
+    desc = &emi_dir->desc[emi_dir->count];
+    desc->type       = type;
+    desc->version    = version;
+    desc->region     = region;
+    desc->reserved   = 0;
+    desc->offset     = offset;
+    desc->size       = size;
+    desc->generation = 0;
+
+    /* host only reads descriptors below count */
+    __DMB();
+    emi_dir->count++;
+
+    return desc;
+}
+
 /*
  * emi_config_space - sets up an emi config space pointer
  * @instance: the desired EMI instance (0 or 1 in MEC152x ECs)
@@ -122,4 +122,99 @@ extern int emi_configure_region(emi_t *emi, const EMI_REGION region, const emi_r
  * */
 extern void emi_reset_config(emi_t *emi);
 
+/*
+ * <=== EMI block manager ===>
+ *
+ * -> EMI instance 0 region 1 maps an arena starting with a directory, host
+ *    reads the directory to find every block published by the EC
+ * -> blocks are allocated in the arena via emi_block_publish(), or mapped
+ *    by a whole region via emi_block_publish_region()
+ * -> each descriptor holds a generation word: 0 until data is first ready,
+ *    odd while EC updates the data, even once data is consistent. Host reads
+ *    the generation before and after the data and retries if it changed
+ *
+ * */
+
+#define EMI_DIR_MAGIC   0x52494D45                  ///< 'EMIR'
+#define EMI_DIR_VERSION 1
+
+/*
+ * Block types are read by host tools, do NOT reuse values
+ * */
+typedef enum {
+
+    EMI_BLOCK_NONE          = 0,                    ///< unused descriptor
+    EMI_BLOCK_VPD           = 1,                    ///< EEPROM vital product data
+    EMI_BLOCK_PWRSEQ_TRACE  = 2,                    ///< power sequence timing trace
+    EMI_BLOCK_LOG           = 3,                    ///< binary log ring
+
+} EMI_BLOCK_TYPE;
+
+typedef struct __packed emi_block_desc {
+
+    uint8_t  type;                                  ///< EMI_BLOCK_TYPE
+    uint8_t  version;                               ///< block layout version
+    uint8_t  region;                                ///< EMI region holding the block
+    uint8_t  reserved;                              ///< reserved
+    uint16_t offset;                                ///< block offset within the region
+    uint16_t size;                                  ///< block size in bytes
+    uint32_t generation;                            ///< 0: not ready, odd: updating
+
+} emi_block_desc_t;
+
+typedef struct __packed emi_dir {
+
+    uint32_t magic;                                 ///< EMI_DIR_MAGIC
+    uint8_t  version;                               ///< EMI_DIR_VERSION
+    uint8_t  count;                                 ///< published descriptors
+    uint16_t size;                                  ///< arena size in bytes
+    emi_block_desc_t desc[CONFIG_EMI_MAX_BLOCKS];   ///< block descriptors
+
+} emi_dir_t;
+
+typedef struct emi_block {
+
+    emi_block_desc_t *desc;                         ///< descriptor in the directory
+    void             *data;                         ///< block data, host visible
+
+} emi_block_t;
+
+/*
+ * emi_block_publish - allocate a block in the EMI arena and describe it
+ * @blk:      block handle populated on success, data is zeroed
+ * @type:     block type
+ * @version:  block layout version
+ * @size:     block size in bytes
+ * =>         returns EMI_SUCCESS on success and EMI_FAILURE if arena is full
+ * */
+extern int emi_block_publish(emi_block_t *blk, const EMI_BLOCK_TYPE type,
+                             uint8_t version, uint16_t size);
+
+/*
+ * emi_block_publish_region - map a whole EMI region to EC memory and
+ *                            describe it in the directory
+ * @blk:      block handle populated on success
+ * @type:     block type
+ * @version:  block layout version
+ * @region:   EMI region of instance 0 other than the arena region
+ * @data:     DWORD aligned block data
+ * @size:     block size in bytes
+ * =>         returns EMI_SUCCESS on success and EMI_FAILURE on failure
+ * */
+extern int emi_block_publish_region(emi_block_t *blk, const EMI_BLOCK_TYPE type,
+                                    uint8_t version, const EMI_REGION region,
+                                    void *data, uint16_t size);
+
+/*
+ * emi_block_update_begin - mark block data as being updated
+ * @blk:      a published block
+ * */
+extern void emi_block_update_begin(emi_block_t *blk);
+
+/*
+ * emi_block_update_end - mark block data as consistent and ready
+ * @blk:      a published block
+ * */
+extern void emi_block_update_end(emi_block_t *blk);
+
 #endif
\ No newline at end of file
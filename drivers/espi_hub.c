@@ -27,8 +27,33 @@ static espi_state_handler_t state_handler;
 static espi_acpi_handler_t acpi_handlers[MAX_ACPI_HANDLERS];
 static espi_kbc_handler_t kbc_handler;
 static espi_postcode_handler_t postcode_handler;
+static const struct espihub_pwrseq_hooks *pwrseq_hooks;
 
 /* Registration from other modules */
+void espihub_set_pwrseq_hooks(const struct espihub_pwrseq_hooks *hooks)
+{
+	pwrseq_hooks = hooks;
+}
+
+static inline void espihub_pwrseq_notify(enum espihub_pwrseq_evt evt,
+					 uint8_t signal, uint8_t level)
+{
+	if (pwrseq_hooks) {
+		pwrseq_hooks->event(evt, signal, level);
+	}
+}
+
+static int espihub_pwrseq_wait(espihub_cond_t cond, void *arg,
+			       uint16_t timeout)
+{
+	if (pwrseq_hooks == NULL) {
+		LOG_ERR("No power sequencing hooks");
+		return -ENODEV;
+	}
+
+	return pwrseq_hooks->wait(cond, arg, timeout);
+}
+
 int espihub_add_state_handler(espi_state_handler_t handler)
 {
 	__ASSERT(handler, "Handler shouldn't be NULL");
@@ -178,6 +203,8 @@ static void espi_reset_handler(const struct device *dev,
 	LOG_WRN("%s", __func__);
 	if (event.evt_type == ESPI_BUS_RESET) {
 		hub.espi_rst_sts = event.evt_data;
+		espihub_pwrseq_notify(ESPIHUB_PWRSEQ_EVT_ESPI_RST, 0,
+				      event.evt_data);
 		LOG_INF("eSPI BUS reset %d", event.evt_data);
 		if (warn_handlers[ESPIHUB_BUS_RESET]) {
 			warn_handlers[ESPIHUB_BUS_RESET](event.evt_data);
@@ -226,6 +253,10 @@ static void vwire_handler(const struct device *dev, struct espi_callback *cb,
 {
 	LOG_INF("VWire %d sts: %d", event.evt_details, event.evt_data);
 	if (event.evt_type == ESPI_BUS_EVENT_VWIRE_RECEIVED) {
+		/* Power sequencing may be waiting on any virtual wire */
+		espihub_pwrseq_notify(ESPIHUB_PWRSEQ_EVT_VWIRE,
+				      event.evt_details, event.evt_data);
+
 		switch (event.evt_details) {
 		case ESPI_VWIRE_SIGNAL_PLTRST:
 			host_warn_handler(event.evt_details, event.evt_data);
@@ -437,59 +468,92 @@ static int handle_vw_ack(enum espi_vwire_signal signal, uint8_t value)
 }
 
 
-int espihub_wait_for_vwire(enum espi_vwire_signal signal, uint16_t timeout,
-		   uint8_t exp_level, bool ack_required)
+struct vwire_cond {
+	enum espi_vwire_signal signal;
+	uint8_t exp_level;
+	uint8_t level;
+};
+
+static int vwire_level_cond(void *arg)
 {
+	struct vwire_cond *vw = arg;
 	int ret;
-	uint8_t level;
-	int loop_cnt = timeout;
 
-	do {
-		ret = espi_receive_vwire(espi_dev, signal, &level);
-		if (ret) {
-			LOG_ERR("Failed to read %x %d", signal, ret);
-			return -EIO;
-		}
+	ret = espi_receive_vwire(espi_dev, vw->signal, &vw->level);
+	if (ret) {
+		LOG_ERR("Failed to read %x %d", vw->signal, ret);
+		return -EIO;
+	}
 
-		if (exp_level == level) {
-			break;
-		}
+	return vw->level == vw->exp_level;
+}
 
-		k_usleep(100);
-		loop_cnt--;
-	} while (loop_cnt > 0 || (timeout == WAIT_TIMEOUT_FOREVER) ||
-		 ec_timeout_status());
+int espihub_wait_for_vwire(enum espi_vwire_signal signal, uint16_t timeout,
+		   uint8_t exp_level, bool ack_required)
+{
+	int ret;
+	struct vwire_cond vw = {
+		.signal = signal,
+		.exp_level = exp_level,
+	};
 
-	if (loop_cnt == 0) {
-		LOG_DBG("VWIRE %d is %x", signal, level);
-		return -ETIMEDOUT;
+	ret = espihub_pwrseq_wait(vwire_level_cond, &vw, timeout);
+	if (ret == -ETIMEDOUT) {
+		LOG_DBG("VWIRE %d is %x", signal, vw.level);
+	}
+
+	if (ret) {
+		return ret;
 	}
 
 	if (ack_required) {
-		handle_vw_ack(signal, level);
+		handle_vw_ack(signal, vw.level);
 	}
 
 	return 0;
 }
 
+static int espi_reset_cond(void *arg)
+{
+	return hub.espi_rst_sts == *(uint8_t *)arg;
+}
+
 int espihub_wait_for_espi_reset(uint8_t exp_sts, uint16_t timeout)
 {
-	int loop_cnt = timeout;
+	return espihub_pwrseq_wait(espi_reset_cond, &exp_sts, timeout);
+}
 
-	do {
-		if (exp_sts == hub.espi_rst_sts) {
-			break;
-		}
-		k_usleep(100);
-		loop_cnt--;
-	} while (loop_cnt > 0 || (timeout == WAIT_TIMEOUT_FOREVER) ||
-		 ec_timeout_status());
+struct pin_vwire_cond {
+	uint32_t port_pin;
+	enum espi_vwire_signal signal;
+	uint8_t abort_sts;
+	int64_t deadline;
+};
 
-	if (loop_cnt == 0) {
-		return -ETIMEDOUT;
+static int pin_low_monitor_vwire_cond(void *arg)
+{
+	struct pin_vwire_cond *pv = arg;
+	uint8_t vw_level;
+	int pin_sts;
+
+	pin_sts = gpio_read_pin(pv->port_pin);
+	if (pin_sts < 0) {
+		LOG_ERR("Fail to read %s pin", __func__);
 	}
 
-	return 0;
+	/* While waiting for pin, monitor virtual wire */
+	espi_receive_vwire(espi_dev, pv->signal, &vw_level);
+	if (vw_level == pv->abort_sts) {
+		LOG_WRN("eSPI host aborted transition");
+		return -EINVAL;
+	}
+
+	if (pin_sts == 0) {
+		return 1;
+	}
+
+	/* Deadline applies even when EC timeouts are disabled */
+	return (k_uptime_ticks() >= pv->deadline) ? -ETIMEDOUT : 0;
 }
 
 int wait_for_pin_monitor_vwire(uint32_t port_pin, uint32_t exp_sts,
@@ -497,33 +561,21 @@ int wait_for_pin_monitor_vwire(uint32_t port_pin, uint32_t exp_sts,
 			       enum espi_vwire_signal signal,
 			       uint8_t abort_sts)
 {
-	int loop_cnt = timeout;
-	uint8_t vw_level;
-	int pin_sts;
-
-	do {
-		pin_sts = gpio_read_pin(port_pin);
-		if (pin_sts < 0) {
-			LOG_ERR("Fail to read %s pin", __func__);
-		}
-
-		/* While waiting for pin, monitor virtual wire */
-		espi_receive_vwire(espi_dev, signal, &vw_level);
-		if (vw_level == abort_sts) {
-			LOG_WRN("eSPI host aborted transition");
-			return -EINVAL;
-		}
-
-		k_usleep(100);
-		loop_cnt--;
-	} while (pin_sts && loop_cnt > 0);
+	int ret;
+	struct pin_vwire_cond pv = {
+		.port_pin = port_pin,
+		.signal = signal,
+		.abort_sts = abort_sts,
+		.deadline = k_uptime_ticks() +
+			    k_us_to_ticks_ceil64(timeout * 100ULL),
+	};
 
-	if (loop_cnt == 0) {
+	ret = espihub_pwrseq_wait(pin_low_monitor_vwire_cond, &pv, timeout);
+	if (ret == -ETIMEDOUT) {
 		LOG_ERR("%d never occurred", exp_sts);
-		return -ETIMEDOUT;
 	}
 
-	return 0;
+	return ret;
 }
 
 int espihub_retrieve_vw(enum espi_vwire_signal signal,
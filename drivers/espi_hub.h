@@ -45,6 +45,38 @@ typedef void (*espi_state_handler_t)(uint32_t signal, uint32_t status);
 typedef void (*espi_kbc_handler_t)(uint8_t data, uint8_t status);
 typedef void (*espi_postcode_handler_t)(uint8_t port_index, uint8_t code);
 
+/**
+ * @brief eSPI inputs power sequencing may wait on.
+ */
+enum espihub_pwrseq_evt {
+	ESPIHUB_PWRSEQ_EVT_VWIRE,
+	ESPIHUB_PWRSEQ_EVT_ESPI_RST,
+};
+
+/**
+ * @brief Condition evaluated while waiting for an eSPI input.
+ *
+ * @retval 1 if condition is met, 0 if not yet, negative errno to abort.
+ */
+typedef int (*espihub_cond_t)(void *arg);
+
+/**
+ * @brief Hooks provided by power sequencing to eSPI hub.
+ */
+struct espihub_pwrseq_hooks {
+	/**
+	 * Called from ISR on every virtual wire and eSPI reset event, signal
+	 * is the virtual wire, level its new level or eSPI reset status.
+	 */
+	void (*event)(enum espihub_pwrseq_evt evt, uint8_t signal,
+		      uint8_t level);
+	/**
+	 * Wait until condition is met, timeout expressed in multiple of 100us.
+	 * Returns 0, -ETIMEDOUT or negative errno from condition.
+	 */
+	int (*wait)(espihub_cond_t cond, void *arg, uint16_t timeout);
+};
+
 #define	ESPIHUB_VW_LOW	0
 #define	ESPIHUB_VW_HIGH	1
 
@@ -148,19 +180,33 @@ int espihub_wait_for_vwire(enum espi_vwire_signal signal, uint16_t timeout,
  *
  * Note: This is used to detect glitches or when VW indicate abort.
  *
+ * Unlike other eSPI hub waits, timeout always applies, even when EC
+ * timeouts are disabled or timeout is WAIT_TIMEOUT_FOREVER. Pin reaching
+ * expected value right at the deadline is reported as success.
+ *
  * @param port_pin a EC GPIO. See @ec_gpio.h.
  * @param exp_sts the expected pin value.
  * @param timeout value expressed in multiple of 100us.
  * @param signal the virtual wire to monitor.
  * @param abort_sts the virtual wire status that indicates to abort the wait.
  *
- * @retval -ETIMEDOUT or 0 if success.
+ * @retval -ETIMEDOUT, -EINVAL if aborted by host or 0 if success.
  */
 int wait_for_pin_monitor_vwire(uint32_t port_pin, uint32_t exp_sts,
 			       uint16_t timeout,
 			       enum espi_vwire_signal signal,
 			       uint8_t abort_sts);
 
+/**
+ * @brief Set power sequencing hooks.
+ *
+ * eSPI hub waits are driven by power sequencing events, hence must only be
+ * used once hooks are set.
+ *
+ * @param hooks power sequencing hooks, must remain valid.
+ */
+void espihub_set_pwrseq_hooks(const struct espihub_pwrseq_hooks *hooks);
+
 /**
  * @brief Add a system state handler.
  * States are tracked via eSPI host virtual wire notifications for each
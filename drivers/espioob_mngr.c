@@ -15,37 +15,124 @@ LOG_MODULE_REGISTER(oobmngr, CONFIG_ESPIOOB_MNGR_LOG_LEVEL);
 
 #define MAX_OOB_BUF_SIZE		75U
 
-#define ASYNC_MSGQ_MAX_MSGS		8U
+#define ASYNC_MSGQ_MAX_MSGS		CONFIG_OOBMNGR_POOL_BLOCKS
 #define ASYNC_MSGQ_ALIGNMENT		4U
 
 #define OOB_MSG_LEN_FROM_BYTE_CNT(x)	(x + OOB_IDX_BYTE_CNT + 1)
 
+/* Pool block backing an OOB message. Blocks are passed by reference
+ * between rx ISR, message queue and handlers, and returned to the pool
+ * once last reference is dropped.
+ */
+struct oob_buf {
+	atomic_t ref;
+	uint16_t len;
+	uint8_t from;
+	/* Cycle count when message was retrieved from eSPI */
+	uint32_t rx_cyc;
+	oob_rx_callback_handler_t fn;
+	uint8_t buf[MAX_OOB_BUF_SIZE];
+};
+
+K_MEM_SLAB_DEFINE(oob_pool, sizeof(struct oob_buf), CONFIG_OOBMNGR_POOL_BLOCKS,
+		  ASYNC_MSGQ_ALIGNMENT);
+
+/* Only used to drain the eSPI rx when no pool block is available */
 static uint8_t rx_buf[MAX_OOB_BUF_SIZE];
 
-struct oob_msg {
-	struct espi_oob_packet *tx;
-	struct espi_oob_packet *rx;
-	struct k_mutex txn_lock;
-	struct k_sem txn_sync;
+/* Outstanding EC initiated request. Responses are matched by master and
+ * command code, hence only one request per master and command code can be
+ * outstanding while requests to different masters or with different
+ * command codes are pipelined.
+ */
+struct oob_txn {
+	bool active;
+	uint8_t master;
+	uint8_t cmd;
+	int64_t deadline;
+	uint32_t tx_cyc;
+	/* Response handed over by rx handler */
+	struct oob_buf *rx;
+	struct k_sem done;
+};
+
+/* Requests that timed out recently, used to identify late responses */
+struct oob_expired {
+	uint8_t master;
+	uint8_t cmd;
+	int64_t until;
 };
 
-static struct oob_msg master_hw;
-static struct oob_msg master_pmc;
-static struct oob_msg master_csme;
+static struct oob_txn txn_tbl[CONFIG_OOBMNGR_MAX_OUTSTANDING];
+static struct oob_expired expired_tbl[CONFIG_OOBMNGR_MAX_OUTSTANDING];
+static struct oob_mngr_stats stats;
+
+/* Protects transaction tables, accessed from rx ISR */
+static struct k_spinlock txn_lock;
+
+/* Serializes access to the eSPI OOB tx channel */
+K_MUTEX_DEFINE(tx_lock);
+
+/* Signalled when a transaction slot is released, so a request waiting for
+ * an identical one to complete can be sent. Slots are only released from
+ * thread context.
+ */
+K_MUTEX_DEFINE(txn_wait_lock);
+K_CONDVAR_DEFINE(txn_released);
+
+#ifdef CONFIG_OOBMNGR_RX_POLL
+/* Resets poller backoff when a response is expected */
+K_SEM_DEFINE(poll_kick, 0, 1);
+#endif
 
 static oob_rx_callback_handler_t csme_msg_hndlr;
 static oob_rx_callback_handler_t pmc_msg_hndlr;
 
-struct async_msb {
-	uint8_t buf[MAX_OOB_BUF_SIZE];
-	uint16_t len;
-	uint8_t from;
-	oob_rx_callback_handler_t fn;
-};
-
-K_MSGQ_DEFINE(async_msgq, sizeof(struct async_msb), ASYNC_MSGQ_MAX_MSGS,
+K_MSGQ_DEFINE(async_msgq, sizeof(struct oob_buf *), ASYNC_MSGQ_MAX_MSGS,
 	ASYNC_MSGQ_ALIGNMENT);
 
+static struct oob_buf *oob_buf_alloc(void)
+{
+	struct oob_buf *blk;
+
+	/* Never block, this is called from ISR */
+	if (k_mem_slab_alloc(&oob_pool, (void **)&blk, K_NO_WAIT)) {
+		return NULL;
+	}
+
+	atomic_set(&blk->ref, 1);
+	blk->len = 0;
+	blk->fn = NULL;
+
+	return blk;
+}
+
+static inline void oob_buf_get(struct oob_buf *blk)
+{
+	atomic_inc(&blk->ref);
+}
+
+static void oob_buf_put(struct oob_buf *blk)
+{
+	if (atomic_dec(&blk->ref) == 1) {
+		k_mem_slab_free(&oob_pool, (void **)&blk);
+	}
+}
+
+struct oob_buf *oob_buf_hold(struct espi_oob_packet *pkt)
+{
+	struct oob_buf *blk = CONTAINER_OF(pkt->buf, struct oob_buf, buf);
+
+	oob_buf_get(blk);
+
+	return blk;
+}
+
+void oob_buf_release(struct oob_buf *blk)
+{
+	oob_buf_put(blk);
+}
+
 
 void register_oob_hndlr(uint8_t master_addr, oob_rx_callback_handler_t fn)
 {
@@ -132,29 +219,144 @@ static int verify_oob_rx_pckt(struct espi_oob_packet *rx)
 	return 0;
 }
 
-static inline struct oob_msg *get_oob_master(uint8_t addr_byte)
+static inline uint32_t oob_cyc_to_us(uint32_t start)
+{
+	return k_cyc_to_us_floor32(k_cycle_get_32() - start);
+}
+
+/* Must be called with txn_lock held */
+static void oob_update_lat(uint32_t *max, uint64_t *total, uint32_t start)
 {
-	/* Decode 7bit master address from 8bit address value */
-	uint8_t master_addr = OOB_7BIT_ADDR(addr_byte);
+	uint32_t lat = oob_cyc_to_us(start);
 
+	*total += lat;
+	if (lat > *max) {
+		*max = lat;
+	}
+}
+
+static inline void oob_poll_kick(void)
+{
+#ifdef CONFIG_OOBMNGR_RX_POLL
+	k_sem_give(&poll_kick);
+#endif
+}
+
+#ifdef CONFIG_OOBMNGR_RX_POLL
+static bool oob_txn_pending(void)
+{
+	bool pending = false;
+	k_spinlock_key_t key = k_spin_lock(&txn_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(txn_tbl); i++) {
+		if (txn_tbl[i].active) {
+			pending = true;
+			break;
+		}
+	}
+	k_spin_unlock(&txn_lock, key);
+
+	return pending;
+}
+#endif
+
+static inline bool is_oob_master(uint8_t master_addr)
+{
 	switch (master_addr) {
 	case OOB_MASTER_ADDR_HW:
-		return &master_hw;
 	case OOB_MASTER_ADDR_CSME:
-		return &master_csme;
 	case OOB_MASTER_ADDR_PMC:
-		return &master_pmc;
+		return true;
 	default:
-		return NULL;
+		return false;
 	}
 }
 
+static struct oob_txn *oob_txn_alloc(uint8_t master, uint8_t cmd,
+				     int wait_time)
+{
+	struct oob_txn *txn = NULL;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&txn_lock);
+	for (int i = 0; i < ARRAY_SIZE(txn_tbl); i++) {
+		if (!txn_tbl[i].active) {
+			if (txn == NULL) {
+				txn = &txn_tbl[i];
+			}
+		} else if (txn_tbl[i].master == master &&
+			   txn_tbl[i].cmd == cmd) {
+			/* Response could not be told apart */
+			txn = NULL;
+			break;
+		}
+	}
+
+	if (txn) {
+		txn->active = true;
+		txn->master = master;
+		txn->cmd = cmd;
+		txn->deadline = k_uptime_get() + wait_time;
+		txn->rx = NULL;
+		/* Nobody waits on a free slot, safe to re-initialize */
+		k_sem_init(&txn->done, 0, 1);
+	}
+	k_spin_unlock(&txn_lock, key);
 
-int oob_send_sync(struct espi_oob_packet *req, struct espi_oob_packet *resp,
-		  int timeout)
+	return txn;
+}
+
+/* Called once a slot is marked inactive. Waiters check slots with
+ * txn_wait_lock held, hence the release cannot be missed.
+ */
+static void oob_txn_signal_released(void)
+{
+	k_mutex_lock(&txn_wait_lock, K_FOREVER);
+	k_condvar_broadcast(&txn_released);
+	k_mutex_unlock(&txn_wait_lock);
+}
+
+/* Must be called with txn_lock held */
+static void oob_txn_expire(struct oob_txn *txn)
 {
-	int ret = 0;
-	struct oob_msg *master;
+	struct oob_expired *slot = &expired_tbl[0];
+
+	/* Reuse the entry expiring first */
+	for (int i = 1; i < ARRAY_SIZE(expired_tbl); i++) {
+		if (expired_tbl[i].until < slot->until) {
+			slot = &expired_tbl[i];
+		}
+	}
+
+	slot->master = txn->master;
+	slot->cmd = txn->cmd;
+	slot->until = k_uptime_get() + MAX_WAIT_TIME_FOR_OOB_IN_MS;
+	stats.timeouts++;
+}
+
+/* Must be called with txn_lock held */
+static bool oob_txn_is_late(uint8_t master, uint8_t cmd)
+{
+	int64_t now = k_uptime_get();
+
+	for (int i = 0; i < ARRAY_SIZE(expired_tbl); i++) {
+		if (expired_tbl[i].until > now &&
+		    expired_tbl[i].master == master &&
+		    expired_tbl[i].cmd == cmd) {
+			expired_tbl[i].until = 0;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int oob_txn_submit(struct espi_oob_packet *req, int timeout,
+		   struct oob_txn **txn)
+{
+	int ret;
+	uint8_t master;
+	int64_t end;
 	int wait_time = MAX(MIN(timeout, MAX_WAIT_TIME_FOR_OOB_IN_MS),
 		MIN_WAIT_TIME_FOR_OOB_IN_MS);
 
@@ -162,7 +364,7 @@ int oob_send_sync(struct espi_oob_packet *req, struct espi_oob_packet *resp,
 	return -ENOTSUP;
 #endif
 
-	if ((req == NULL) || (resp == NULL)) {
+	if ((req == NULL) || (txn == NULL)) {
 		return -ENODATA;
 	}
 
@@ -172,58 +374,159 @@ int oob_send_sync(struct espi_oob_packet *req, struct espi_oob_packet *resp,
 		return ret;
 	}
 
-	master = get_oob_master(req->buf[OOB_IDX_DEST_SLV_ADDR]);
-
-	if (master == NULL) {
+	master = OOB_7BIT_ADDR(req->buf[OOB_IDX_DEST_SLV_ADDR]);
+	if (!is_oob_master(master)) {
 		return -EINVAL;
 	}
 
-	if (k_mutex_lock(&master->txn_lock,
-			 K_MSEC(MIN_WAIT_TIME_FOR_OOB_IN_MS))) {
-		LOG_ERR("OOB tx lock timeout");
-		return -EBUSY;
+	/* Wait for a previous identical request to complete */
+	end = k_uptime_get() + MIN_WAIT_TIME_FOR_OOB_IN_MS;
+	k_mutex_lock(&txn_wait_lock, K_FOREVER);
+	while ((*txn = oob_txn_alloc(master, req->buf[OOB_IDX_CMD_CODE],
+				     wait_time)) == NULL) {
+		int64_t remaining = end - k_uptime_get();
+
+		if (remaining <= 0 ||
+		    k_condvar_wait(&txn_released, &txn_wait_lock,
+				   K_MSEC(remaining))) {
+			k_mutex_unlock(&txn_wait_lock);
+			LOG_ERR("OOB tx lock timeout");
+			return -EBUSY;
+		}
 	}
+	k_mutex_unlock(&txn_wait_lock);
 
-	master->tx = req;
-	master->rx = resp;
-	k_sem_reset(&master->txn_sync);
+	k_mutex_lock(&tx_lock, K_FOREVER);
+	(*txn)->tx_cyc = k_cycle_get_32();
+	ret = espihub_send_oob(req);
+	k_mutex_unlock(&tx_lock);
 
-	ret = espihub_send_oob(master->tx);
 	if (ret) {
+		k_spinlock_key_t key = k_spin_lock(&txn_lock);
+
 		LOG_ERR("Error sending OOB %d", ret);
-		k_mutex_unlock(&master->txn_lock);
-		k_sem_give(&master->txn_sync);
+		(*txn)->active = false;
+		k_spin_unlock(&txn_lock, key);
+		oob_txn_signal_released();
 		return -EIO;
 	}
 
 	LOG_DBG("OOB Tx Successful");
+	oob_poll_kick();
+
+	return 0;
+}
+
+/**
+ * @brief Wait for an outstanding transaction response.
+ *
+ * On success, rx holds a reference to the pool block with the response
+ * which must be released by the caller. The transaction slot is released
+ * in all cases.
+ */
+static int oob_txn_wait_buf(struct oob_txn *txn, struct oob_buf **rx)
+{
+	int64_t remaining = txn->deadline - k_uptime_get();
+	struct oob_buf *blk;
+	k_spinlock_key_t key;
+
+	/* Wait till OOB response, semaphore released by rx handler */
+	k_sem_take(&txn->done, K_MSEC(MAX(remaining, 0)));
+
+	/* Response may still land after timeout, collect it atomically so
+	 * it is not leaked.
+	 */
+	key = k_spin_lock(&txn_lock);
+	blk = txn->rx;
+	txn->rx = NULL;
+	txn->active = false;
+	if (blk == NULL) {
+		oob_txn_expire(txn);
+	}
+	k_spin_unlock(&txn_lock, key);
+	oob_txn_signal_released();
+
+	if (blk == NULL) {
+		LOG_ERR("OOB Rx timeout %x:%x", txn->master, txn->cmd);
+		return -ETIMEDOUT;
+	}
+
+	LOG_DBG("OOB Rx Successful");
+	*rx = blk;
+
+	return 0;
+}
 
-	/* Wait till OOB response, txn_sync semaphore released by rx handler */
-	ret = k_sem_take(&master->txn_sync, K_MSEC(wait_time));
+int oob_txn_wait(struct oob_txn *txn, struct espi_oob_packet *resp)
+{
+	int ret;
+	struct oob_buf *blk;
 
+	ret = oob_txn_wait_buf(txn, &blk);
 	if (ret) {
-		LOG_ERR("OOB Rx sem timeout");
-		ret = -ETIMEDOUT;
+		return ret;
+	}
+
+	if (resp->len >= blk->len) {
+		memcpys(resp->buf, blk->buf, blk->len);
+		resp->len = blk->len;
 	} else {
-		if (master->rx->len) {
-			LOG_DBG("OOB Rx Successful");
-		} else {
-			LOG_ERR("OOB Rx received, but buffer space not enough");
-			ret = -ENOBUFS;
-		}
+		LOG_ERR("OOB Rx received, but buffer space not enough");
+		resp->len = 0;
+		ret = -ENOBUFS;
 	}
 
-	k_mutex_unlock(&master->txn_lock);
-	k_sem_give(&master->txn_sync);
+	oob_buf_put(blk);
 
 	return ret;
 }
 
+void oob_get_stats(struct oob_mngr_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&txn_lock);
+
+	*out = stats;
+	k_spin_unlock(&txn_lock, key);
+}
+
+void oob_report_stats(void)
+{
+	struct oob_mngr_stats st;
+
+	oob_get_stats(&st);
+
+	LOG_INF("OOB completed %u timeouts %u late %u orphans %u",
+		st.completed, st.timeouts, st.late, st.orphans);
+	LOG_INF("OOB rsp avg %u max %u us, rx %u avg %u max %u us",
+		(uint32_t)(st.rsp_lat_total_us / MAX(st.completed, 1U)),
+		st.rsp_lat_max_us, st.dispatched,
+		(uint32_t)(st.rx_lat_total_us / MAX(st.dispatched, 1U)),
+		st.rx_lat_max_us);
+}
+
+int oob_send_sync(struct espi_oob_packet *req, struct espi_oob_packet *resp,
+		  int timeout)
+{
+	int ret;
+	struct oob_txn *txn;
+
+	if (resp == NULL) {
+		return -ENODATA;
+	}
+
+	ret = oob_txn_submit(req, timeout, &txn);
+	if (ret) {
+		return ret;
+	}
+
+	return oob_txn_wait(txn, resp);
+}
+
 
 int oob_send_async(struct espi_oob_packet *req, oob_rx_callback_handler_t cb)
 {
 	int ret;
-	struct async_msb msg;
+	struct oob_buf *msg;
 
 #ifndef CONFIG_OOBMNGR_SUPPORT
 	return -ENOTSUP;
@@ -239,14 +542,22 @@ int oob_send_async(struct espi_oob_packet *req, oob_rx_callback_handler_t cb)
 		return ret;
 	}
 
-	msg.len = req->len;
-	memcpys(msg.buf, req->buf, req->len);
-	msg.fn = cb;
-	msg.from = OOB_SLAVE_ADDR_EC;
+	msg = oob_buf_alloc();
+	if (msg == NULL) {
+		LOG_ERR("No OOB buffer available");
+		return -ENOBUFS;
+	}
+
+	/* Caller buffer may not outlive this call, hence single copy */
+	msg->len = req->len;
+	memcpys(msg->buf, req->buf, req->len);
+	msg->fn = cb;
+	msg->from = OOB_SLAVE_ADDR_EC;
 
 	ret = k_msgq_put(&async_msgq, &msg, K_NO_WAIT);
 	if (ret) {
 		LOG_ERR("Async msg request enque failed %d", ret);
+		oob_buf_put(msg);
 		return -ENOBUFS;
 	}
 
@@ -257,7 +568,6 @@ int oob_send_async(struct espi_oob_packet *req, oob_rx_callback_handler_t cb)
 int oob_respond_master(struct espi_oob_packet *tx)
 {
 	int ret;
-	struct oob_msg *master;
 
 #ifndef CONFIG_OOBMNGR_SUPPORT
 	return -ENOTSUP;
@@ -273,20 +583,16 @@ int oob_respond_master(struct espi_oob_packet *tx)
 		return ret;
 	}
 
-	master = get_oob_master(tx->buf[OOB_IDX_DEST_SLV_ADDR]);
-
-	if (master == NULL) {
+	if (!is_oob_master(OOB_7BIT_ADDR(tx->buf[OOB_IDX_DEST_SLV_ADDR]))) {
 		return -EINVAL;
 	}
 
-	if (k_mutex_lock(&master->txn_lock, K_NO_WAIT)) {
+	if (k_mutex_lock(&tx_lock, K_NO_WAIT)) {
 		LOG_ERR("OOB tx lock timeout");
 		return -EBUSY;
 	}
 
-	master->tx = tx;
-
-	ret = espihub_send_oob(master->tx);
+	ret = espihub_send_oob(tx);
 	if (ret) {
 		LOG_ERR("Error sending OOB %d", ret);
 		ret = -EIO;
@@ -294,147 +600,191 @@ int oob_respond_master(struct espi_oob_packet *tx)
 		LOG_DBG("OOB Tx Successful");
 	}
 
-	k_mutex_unlock(&master->txn_lock);
+	k_mutex_unlock(&tx_lock);
 	return ret;
 }
 
 
 /* Intended to be handled as in ISR - No Lengthy routines */
-static void oob_rx_handler(struct espi_oob_packet *rx)
+static void oob_rx_handler(struct oob_buf *blk)
 {
 	int ret;
-	struct oob_msg *master;
-	struct async_msb msg;
+	uint8_t master;
+	uint8_t cmd;
+	bool late = false;
+	k_spinlock_key_t key;
+	struct espi_oob_packet rx = {
+		.buf = blk->buf,
+		.len = blk->len
+	};
 
 	/* Validate OOB message */
-	ret = verify_oob_rx_pckt(rx);
+	ret = verify_oob_rx_pckt(&rx);
 	if (ret) {
 		LOG_ERR("Invalid Rx packet");
 		return;
 	}
 
 	/* Find the OOB Rx master */
-	master = get_oob_master(rx->buf[OOB_IDX_SRC_SLV_ADDR]);
+	master = OOB_7BIT_ADDR(rx.buf[OOB_IDX_SRC_SLV_ADDR]);
+	cmd = rx.buf[OOB_IDX_CMD_CODE];
 
-	if (master == NULL) {
+	if (!is_oob_master(master)) {
 		LOG_ERR("Msg from Unknown master - Discard");
-
-		/* Clear Rx buffer for next downstream oob */
-		memsets(rx->buf, 0, rx->len);
-		rx->len = sizeof(rx_buf);
 		return;
 	}
 
 	/*
-	 * Route the OOB Rx to appropriate Rx buffer.
-	 * If OOB rx received when semaphore not acquired by EC i.e. sem_count
-	 * is a non-zero value, then the downstream OOB message is treated as
-	 * master initiated OOB request.
-	 * If OOB rx received when semaphore is already acquired by EC for the
-	 * same master i.e. sem_count = 0, then the downstream OOB message is
-	 * tied as a response to the EC initiated OOB request message. Semaphore
-	 * must be released then for the waiting task to catch the response.
+	 * Route the OOB Rx. A message matching an outstanding request by
+	 * master and command code is its response, the pool block itself is
+	 * handed over to the waiting transaction.
 	 */
-	if (k_sem_count_get(&master->txn_sync)) {
-		/*
-		 * This is where CSME incoming messages can be handled
-		 *
-		 * Also OOB responses received post timeout land up here.
-		 * No action needed, they can be discarded. Warning log is
-		 * enough. When that happens, MIN_WAIT_TIME should be tweaked.
-		 */
-
-		if (rx->len < sizeof(msg.buf)) {
-			memcpys(msg.buf, rx->buf, rx->len);
-			msg.fn = NULL;
-			msg.len = rx->len;
-			msg.from = OOB_7BIT_ADDR(rx->buf[OOB_IDX_SRC_SLV_ADDR]);
-
-			if (k_msgq_put(&async_msgq, &msg, K_NO_WAIT)) {
-				LOG_ERR("Rx msg enque failed %d", ret);
-			}
-		} else {
-			LOG_ERR("Rx Message size too big.");
+	key = k_spin_lock(&txn_lock);
+	for (int i = 0; i < ARRAY_SIZE(txn_tbl); i++) {
+		struct oob_txn *txn = &txn_tbl[i];
+
+		if (txn->active && txn->rx == NULL && txn->master == master &&
+		    txn->cmd == cmd) {
+			oob_buf_get(blk);
+			txn->rx = blk;
+			stats.completed++;
+			oob_update_lat(&stats.rsp_lat_max_us,
+				       &stats.rsp_lat_total_us, txn->tx_cyc);
+			k_sem_give(&txn->done);
+			k_spin_unlock(&txn_lock, key);
+			return;
 		}
-
-	} else {
-
-		if (master->rx->len >= rx->len) {
-			memcpys(master->rx->buf, rx->buf, rx->len);
-			master->rx->len = rx->len;
-		} else {
-			master->rx->len = 0;
-			LOG_WRN("Rx Buf space too small");
-		}
-
-		k_sem_give(&master->txn_sync);
 	}
 
+	late = oob_txn_is_late(master, cmd);
+	if (late) {
+		stats.late++;
+	} else if (master == OOB_MASTER_ADDR_HW) {
+		/* HW master never initiates messages */
+		stats.orphans++;
+	}
+	k_spin_unlock(&txn_lock, key);
 
-	/* Clear Rx buffer for next downstream oob */
-	memsets(rx->buf, 0, rx->len);
-	rx->len = sizeof(rx_buf);
-}
+	if (late || master == OOB_MASTER_ADDR_HW) {
+		/* If this happens often, MIN_WAIT_TIME should be tweaked */
+		LOG_WRN("Unexpected OOB response %x:%x %s", master, cmd,
+			late ? "late" : "orphan");
+	}
 
-static void oobmngr_init(void)
-{
-	k_mutex_init(&master_hw.txn_lock);
-	k_mutex_init(&master_pmc.txn_lock);
-	k_mutex_init(&master_csme.txn_lock);
+	/*
+	 * Unmatched messages are passed to master handler as before, e.g.
+	 * CSME incoming messages. Late and orphan responses are only counted,
+	 * they may still be master initiated messages.
+	 */
+	blk->fn = NULL;
+	blk->from = master;
 
-	k_sem_init(&master_hw.txn_sync, 1, 1);
-	k_sem_init(&master_pmc.txn_sync, 1, 1);
-	k_sem_init(&master_csme.txn_sync, 1, 1);
+	oob_buf_get(blk);
+	if (k_msgq_put(&async_msgq, &blk, K_NO_WAIT)) {
+		LOG_ERR("Rx msg enque failed");
+		oob_buf_put(blk);
+	}
 }
 
-
 void oobmngr_thread(void *p1, void *p2, void *p3)
 {
 	int ret;
-	struct async_msb msg;
-
-	oobmngr_init();
+	struct oob_buf *msg;
+	struct oob_buf *rsp;
 
 	while (1) {
 		k_msgq_get(&async_msgq, &msg, K_FOREVER);
 
-		if (msg.from == OOB_SLAVE_ADDR_EC) {
+		if (msg->from == OOB_SLAVE_ADDR_EC) {
 			/* OOB message from EC to master */
 			struct espi_oob_packet req = {
-				.buf = msg.buf, .len = msg.len};
+				.buf = msg->buf, .len = msg->len};
 			struct espi_oob_packet resp = {
-				.buf = msg.buf, .len = sizeof(msg.buf)};
+				.buf = msg->buf, .len = 0};
+			struct oob_txn *txn;
 
-			ret = oob_send_sync(&req, &resp,
-					    OOB_MSG_SYNC_WAIT_TIME_DFLT);
+			ret = oob_txn_submit(&req, OOB_MSG_SYNC_WAIT_TIME_DFLT,
+					     &txn);
+			if (!ret) {
+				ret = oob_txn_wait_buf(txn, &rsp);
+			}
 
 			LOG_DBG("Async msg processed, status: %d", ret);
 
-			if (msg.fn != NULL) {
-				msg.fn(&resp, ret);
+			if (!ret) {
+				resp.buf = rsp->buf;
+				resp.len = rsp->len;
+			}
+
+			if (msg->fn != NULL) {
+				msg->fn(&resp, ret);
+			}
+
+			if (!ret) {
+				oob_buf_put(rsp);
 			}
 		} else {
 			/* Master initiated OOB message */
-			switch (msg.from) {
+			switch (msg->from) {
 			case OOB_MASTER_ADDR_CSME:
-				msg.fn = csme_msg_hndlr;
+				msg->fn = csme_msg_hndlr;
 				break;
 			case OOB_MASTER_ADDR_PMC:
-				msg.fn = pmc_msg_hndlr;
+				msg->fn = pmc_msg_hndlr;
 				break;
 			default:
-				LOG_ERR("Unsupported 0%x", msg.from);
+				LOG_ERR("Unsupported 0%x", msg->from);
 				break;
 			}
 
-			if (msg.fn != NULL) {
+			if (msg->fn != NULL) {
 				struct espi_oob_packet mstr_msg = {
-					.buf = msg.buf, .len = msg.len};
+					.buf = msg->buf, .len = msg->len};
+				k_spinlock_key_t key = k_spin_lock(&txn_lock);
 
-				msg.fn(&mstr_msg, 0);
+				stats.dispatched++;
+				oob_update_lat(&stats.rx_lat_max_us,
+					       &stats.rx_lat_total_us,
+					       msg->rx_cyc);
+				k_spin_unlock(&txn_lock, key);
+
+				msg->fn(&mstr_msg, 0);
 			}
 		}
+
+		oob_buf_put(msg);
+	}
+}
+
+static int oob_rx_retrieve(void)
+{
+	int ret;
+	struct oob_buf *blk = oob_buf_alloc();
+	struct espi_oob_packet rx;
+
+	if (blk == NULL) {
+		/* Still retrieve the message so the channel is not stalled */
+		LOG_ERR("No OOB buffer, Rx dropped");
+		rx.buf = rx_buf;
+		rx.len = sizeof(rx_buf);
+		return espihub_retrieve_oob(&rx);
 	}
+
+	/* Receive straight into the pool block */
+	rx.buf = blk->buf;
+	rx.len = sizeof(blk->buf);
+
+	ret = espihub_retrieve_oob(&rx);
+	if (ret == 0) {
+		blk->len = rx.len;
+		blk->rx_cyc = k_cycle_get_32();
+		oob_rx_handler(blk);
+	}
+
+	/* Handler took its own reference if the block was handed over */
+	oob_buf_put(blk);
+
+	return ret;
 }
 
 void oob_rx_cb_handler(void)
@@ -442,13 +792,30 @@ void oob_rx_cb_handler(void)
 #ifndef CONFIG_OOBMNGR_SUPPORT
 	return;
 #endif
-	struct espi_oob_packet rx = {
-		.buf = rx_buf,
-		.len = sizeof(rx_buf)
-	};
+	oob_rx_retrieve();
+}
+
+#ifdef CONFIG_OOBMNGR_RX_POLL
+void oobmngr_poll_thread(void *p1, void *p2, void *p3)
+{
+	uint32_t period = CONFIG_OOBMNGR_POLL_MIN_MS;
+
+	while (1) {
+		if (!oob_txn_pending()) {
+			/* Nothing expected, sleep until a request is sent */
+			k_sem_take(&poll_kick, K_FOREVER);
+			period = CONFIG_OOBMNGR_POLL_MIN_MS;
+		} else if (k_sem_take(&poll_kick, K_MSEC(period)) == 0) {
+			/* Poll at highest rate right after a request is sent */
+			period = CONFIG_OOBMNGR_POLL_MIN_MS;
+		}
 
-	if (espihub_retrieve_oob(&rx) == 0) {
-		oob_rx_handler(&rx);
+		if (oob_rx_retrieve() == 0) {
+			/* More messages may follow */
+			period = CONFIG_OOBMNGR_POLL_MIN_MS;
+		} else {
+			period = MIN(period * 2, CONFIG_OOBMNGR_POLL_MAX_MS);
+		}
 	}
 }
-
+#endif
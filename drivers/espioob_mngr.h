@@ -109,8 +109,8 @@ void oobmngr_thread(void *p1, void *p2, void *p3);
  *		   - invalid len if less than espi header size (4) or more than
  *		     max OOB packet buf size (75)
  * @return -ENODATA when request or response buffers are null.
- * @return -EBUSY when eSPI OOB channel is busy with an ongoing transaction for
- *		  the same master address.
+ * @return -EBUSY when an identical request to the same master is still
+ *		  outstanding.
  * @return -EIO General input / output error, failed to send over the bus.
  * @return -ETIMEDOUT response not received within timeout.
  * @return -ENOBUFS response buffer size is less than desired size.
@@ -120,6 +120,73 @@ void oobmngr_thread(void *p1, void *p2, void *p3);
 int oob_send_sync(struct espi_oob_packet *req, struct espi_oob_packet *resp,
 	int timeout);
 
+struct oob_txn;
+
+/**
+ * @brief OOB manager transaction counters.
+ */
+struct oob_mngr_stats {
+	/* Responses matched to an outstanding request */
+	uint32_t completed;
+	/* Requests without response before their deadline */
+	uint32_t timeouts;
+	/* Responses received after their request timed out */
+	uint32_t late;
+	/* Responses not matching any request */
+	uint32_t orphans;
+	/* Master initiated messages passed to their handler */
+	uint32_t dispatched;
+	/* Request sent to response received, in us */
+	uint32_t rsp_lat_max_us;
+	uint64_t rsp_lat_total_us;
+	/* Master initiated message received to dispatched, in us */
+	uint32_t rx_lat_max_us;
+	uint64_t rx_lat_total_us;
+};
+
+/**
+ * @brief Issue an OOB request without waiting for its response.
+ *
+ * Requests to different masters, or with different command codes, may be
+ * outstanding at the same time. Responses are matched to requests by master
+ * address and command code. A request identical to an outstanding one waits
+ * up to MIN_WAIT_TIME_FOR_OOB_IN_MS for it to complete.
+ *
+ * @param req eSPI OOB request packet.
+ * @param timeout max time in miliseconds for receiving OOB response, counted
+ *		  from submission.
+ * @param txn transaction handle to be passed to oob_txn_wait().
+ *
+ * @return 0 if successful, otherwise same error codes as oob_send_sync().
+ *
+ * @note Can only be run from thread. Every successful submission must be
+ * followed by oob_txn_wait().
+ */
+int oob_txn_submit(struct espi_oob_packet *req, int timeout,
+		   struct oob_txn **txn);
+
+/**
+ * @brief Wait for the response to a submitted OOB request.
+ *
+ * @param txn transaction handle returned by oob_txn_submit().
+ * @param resp eSPI OOB response packet.
+ *
+ * @return 0 if successful, -ETIMEDOUT or -ENOBUFS otherwise.
+ */
+int oob_txn_wait(struct oob_txn *txn, struct espi_oob_packet *resp);
+
+/**
+ * @brief Get OOB manager transaction counters.
+ *
+ * @param stats counters since boot.
+ */
+void oob_get_stats(struct oob_mngr_stats *stats);
+
+/**
+ * @brief Log OOB manager transaction counters and average latencies.
+ */
+void oob_report_stats(void);
+
 /**
  * @brief Function pointer definition for handling asynchronous OOB response.
  *
@@ -150,8 +217,8 @@ typedef void (*oob_rx_callback_handler_t) (struct espi_oob_packet *rx,
  *		   - invalid len if less than espi header size (4) or more than
  *		     max OOB packet buf size (75).
  * @return -ENODATA when request buffer is null.
- * @return -ENOBUFS when too many OOB requests are queued and no space available
- *		    to queue another one.
+ * @return -ENOBUFS when too many OOB requests are queued or no OOB buffer is
+ *		    available to queue another one.
  */
 int oob_send_async(struct espi_oob_packet *req, oob_rx_callback_handler_t cb);
 
@@ -174,8 +241,7 @@ int oob_send_async(struct espi_oob_packet *req, oob_rx_callback_handler_t cb);
  *		   - invalid len if less than espi header size (4) or more than
  *		     max OOB packet buf size (75)
  * @return -ENODATA when tx buffer is null.
- * @return -EBUSY when eSPI OOB channel is busy with an ongoing transaction for
- *		  the same master address.
+ * @return -EBUSY when eSPI OOB channel is busy sending another message.
  * @return -EIO General input / output error, failed to send over the bus.
  */
 int oob_respond_master(struct espi_oob_packet *tx);
@@ -185,11 +251,47 @@ int oob_respond_master(struct espi_oob_packet *tx);
  *
  * @note This function is executed within ISR, and only intended for eSPI_hub to
  * assign to the driver callback, when eSPI driver supports callback for OOB rx.
- * If driver does not support OOB rx callback, this routine must be run from
- * a thread to ensure the OOB rx retrieved.
  */
 void oob_rx_cb_handler(void);
 
+#ifdef CONFIG_OOBMNGR_RX_POLL
+/**
+ * @brief Routine polling downstream OOB messages.
+ *
+ * Only used when eSPI driver does not support callback for OOB rx. Polls
+ * only while an OOB request is outstanding, polling period backs off from
+ * CONFIG_OOBMNGR_POLL_MIN_MS up to CONFIG_OOBMNGR_POLL_MAX_MS while no
+ * message is received.
+ *
+ * @param p1 pointer to additional task-specific data.
+ * @param p2 pointer to additional task-specific data.
+ * @param p2 pointer to additional task-specific data.
+ */
+void oobmngr_poll_thread(void *p1, void *p2, void *p3);
+#endif
+
+/**
+ * @brief Keep the buffer of an OOB message beyond its callback.
+ *
+ * OOB messages delivered to callbacks are backed by pool buffers which are
+ * returned to the pool once the callback returns. A handler deferring the
+ * processing of a message can hold its buffer instead of copying it.
+ *
+ * @param pkt eSPI OOB packet received in a oob_rx_callback_handler_t.
+ *
+ * @return handle to be released with oob_buf_release().
+ *
+ * @note Only valid for packets delivered by the OOB manager with no error.
+ */
+struct oob_buf *oob_buf_hold(struct espi_oob_packet *pkt);
+
+/**
+ * @brief Release an OOB message buffer obtained with oob_buf_hold().
+ *
+ * @param buf handle of the held buffer.
+ */
+void oob_buf_release(struct oob_buf *buf);
+
 /**
  * @brief Register for master initiated OOB message handler.
  *
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __GPIO_EC_FAST_H__
+#define __GPIO_EC_FAST_H__
+
+#include <zephyr.h>
+#include <sys/sys_io.h>
+#include "gpio_ec.h"
+#include "board_config.h"
+
+/**
+ * @brief Direct register GPIO access for polling loops.
+ *
+ * Same semantics as gpio_read_pin()/gpio_write_pin() for SoC GPIOs but
+ * without device lookup and driver API indirection. Functions are always
+ * inlined so when the encoded port/pin is a build time constant, as is the
+ * case for most board pin definitions, the register address and pin mask
+ * are folded by the compiler.
+ *
+ * Dummy pins are resolved without any register access and IO expander pins
+ * fall back to the regular GPIO wrapper.
+ */
+
+#ifdef CONFIG_GPIO_EC_FAST_ACCESS
+
+/* Parallel input and output registers, one 32-bit register per port */
+#define EC_GPIO_CTRL_BASE	DT_REG_ADDR(DT_NODELABEL(gpio_000_036))
+#define EC_GPIO_PARIN_ADDR(port)	(EC_GPIO_CTRL_BASE + 0x300U + \
+					 ((port) * 4U))
+#define EC_GPIO_PAROUT_ADDR(port)	(EC_GPIO_CTRL_BASE + 0x380U + \
+					 ((port) * 4U))
+
+/* Ports accessible through parallel registers */
+#define EC_GPIO_FAST_PORTS	MCHP_GPIO_MAX_PORT
+
+static ALWAYS_INLINE bool gpio_is_fast_port(uint32_t port)
+{
+	return port < EC_GPIO_FAST_PORTS;
+}
+
+/**
+ * @brief Read the raw level of all pins in a SoC GPIO port.
+ *
+ * @param port SoC GPIO port index.
+ *
+ * @retval Port input bitmap, bit n is the level of pin n.
+ */
+static ALWAYS_INLINE uint32_t gpio_fast_read_port(uint32_t port)
+{
+	return sys_read32(EC_GPIO_PARIN_ADDR(port));
+}
+
+/**
+ * @brief Read the level of a pin.
+ *
+ * @param port_pin Encoded port/pin.
+ *
+ * @retval 1 If pin physical level is high.
+ * @retval 0 If pin physical level is low.
+ * @retval Negative errno code on failure, IO expander pins only.
+ */
+static ALWAYS_INLINE int gpio_fast_read_pin(uint32_t port_pin)
+{
+	uint32_t port = gpio_get_port(port_pin);
+	uint32_t pin = gpio_get_pin(port_pin);
+
+	if (port == EC_DUMMY_GPIO_PORT) {
+		return pin;
+	}
+
+	if (!gpio_is_fast_port(port)) {
+		return gpio_read_pin(port_pin);
+	}
+
+	return (gpio_fast_read_port(port) >> pin) & 1U;
+}
+
+/**
+ * @brief Set the level for a pin.
+ *
+ * @param port_pin Encoded port/pin.
+ * @param value Desired logical level.
+ *
+ * @retval 0 if successful, negative errno code on failure, IO expander
+ * pins only.
+ */
+static ALWAYS_INLINE int gpio_fast_write_pin(uint32_t port_pin, int value)
+{
+	uint32_t port = gpio_get_port(port_pin);
+	uint32_t mask = BIT(gpio_get_pin(port_pin));
+	mem_addr_t addr = EC_GPIO_PAROUT_ADDR(port);
+	unsigned int key;
+
+	if (port == EC_DUMMY_GPIO_PORT) {
+		return 0;
+	}
+
+	if (!gpio_is_fast_port(port)) {
+		return gpio_write_pin(port_pin, value);
+	}
+
+	/* Output register is shared by all pins in the port */
+	key = irq_lock();
+	if (value) {
+		sys_write32(sys_read32(addr) | mask, addr);
+	} else {
+		sys_write32(sys_read32(addr) & ~mask, addr);
+	}
+	irq_unlock(key);
+
+	return 0;
+}
+
+#else
+
+static inline int gpio_fast_read_pin(uint32_t port_pin)
+{
+	return gpio_read_pin(port_pin);
+}
+
+static inline int gpio_fast_write_pin(uint32_t port_pin, int value)
+{
+	return gpio_write_pin(port_pin, value);
+}
+
+#endif /* CONFIG_GPIO_EC_FAST_ACCESS */
+
+/* Level reported by gpio_read_pins() for a pin that failed to read */
+#define GPIO_LEVEL_READ_FAILED	0xFFU
+
+/**
+ * @brief Read several pins at once.
+ *
+ * Each SoC GPIO port is sampled once, so levels of pins in the same port
+ * are coherent and reading N pins costs at most one register access per
+ * port involved.
+ *
+ * @param port_pins Array of encoded port/pin.
+ * @param levels Array receiving pin levels, 1 for high, 0 for low,
+ *		 GPIO_LEVEL_READ_FAILED if the pin could not be read.
+ * @param count Number of pins.
+ *
+ * @retval 0 if successful, negative errno code if any pin failed to read.
+ */
+int gpio_read_pins(const uint32_t *port_pins, uint8_t *levels, size_t count);
+
+#endif /* __GPIO_EC_FAST_H__ */
@@ -14,6 +14,7 @@
 #endif
 #include <logging/log.h>
 #include "gpio_ec.h"
+#include "gpio_ec_fast.h"
 #include "common_mec1501.h"
 
 LOG_MODULE_REGISTER(gpio_ec, CONFIG_GPIO_EC_LOG_LEVEL);
@@ -107,6 +108,57 @@ static bool gpio_read_dummy_pin(uint32_t port_pin)
 	return gpio_get_pin(port_pin);
 }
 
+#ifdef CONFIG_GPIO_EC_BENCHMARK
+#define GPIO_BENCH_LOOPS	1000U
+#define GPIO_BENCH_PIN		EC_GPIO_PORT_PIN(MCHP_GPIO_000_036, 0)
+
+static void gpio_benchmark(void)
+{
+	/* Prevent the compiler from folding the pin encoding */
+	volatile uint32_t runtime_pin = GPIO_BENCH_PIN;
+	const uint32_t pins[] = {
+		EC_GPIO_PORT_PIN(MCHP_GPIO_000_036, 0),
+		EC_GPIO_PORT_PIN(MCHP_GPIO_000_036, 1),
+		EC_GPIO_PORT_PIN(MCHP_GPIO_040_076, 0),
+		EC_GPIO_PORT_PIN(MCHP_GPIO_040_076, 1),
+	};
+	uint8_t levels[ARRAY_SIZE(pins)];
+	uint32_t start;
+	uint32_t drv, fast, fast_rt, batch;
+	int i;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		gpio_read_pin(GPIO_BENCH_PIN);
+	}
+	drv = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		gpio_fast_read_pin(GPIO_BENCH_PIN);
+	}
+	fast = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		gpio_fast_read_pin(runtime_pin);
+	}
+	fast_rt = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < GPIO_BENCH_LOOPS; i++) {
+		gpio_read_pins(pins, levels, ARRAY_SIZE(pins));
+	}
+	batch = k_cycle_get_32() - start;
+
+	LOG_INF("GPIO read cycles: driver %u fast %u fast runtime pin %u",
+		drv / GPIO_BENCH_LOOPS, fast / GPIO_BENCH_LOOPS,
+		fast_rt / GPIO_BENCH_LOOPS);
+	LOG_INF("GPIO batched read of %d pins: %u cycles", ARRAY_SIZE(pins),
+		batch / GPIO_BENCH_LOOPS);
+}
+#endif
+
 int gpio_init(void)
 {
 	const struct device *gpio_dev;
@@ -122,6 +174,10 @@ int gpio_init(void)
 		LOG_DBG("[Port %c] %p", (i+0x31), gpio_dev);
 	}
 
+#ifdef CONFIG_GPIO_EC_BENCHMARK
+	gpio_benchmark();
+#endif
+
 	return 0;
 }
 
@@ -218,6 +274,41 @@ int gpio_read_pin(uint32_t port_pin)
 	return gpio_pin_get_raw(pp.gpio_dev, pp.pin);
 }
 
+int gpio_read_pins(const uint32_t *port_pins, uint8_t *levels, size_t count)
+{
+#ifdef CONFIG_GPIO_EC_FAST_ACCESS
+	uint32_t parin[EC_GPIO_FAST_PORTS];
+	uint32_t sampled = 0;
+	uint32_t port;
+#endif
+	int level;
+	int ret = 0;
+
+	for (size_t i = 0; i < count; i++) {
+#ifdef CONFIG_GPIO_EC_FAST_ACCESS
+		port = gpio_get_port(port_pins[i]);
+		if (gpio_is_fast_port(port)) {
+			if (!(sampled & BIT(port))) {
+				parin[port] = gpio_fast_read_port(port);
+				sampled |= BIT(port);
+			}
+
+			levels[i] = (parin[port] >> gpio_get_pin(port_pins[i])) & 1U;
+			continue;
+		}
+#endif
+		level = gpio_read_pin(port_pins[i]);
+		if (level < 0) {
+			ret = level;
+			level = GPIO_LEVEL_READ_FAILED;
+		}
+
+		levels[i] = level;
+	}
+
+	return ret;
+}
+
 int gpio_init_callback_pin(uint32_t port_pin,
 			   struct gpio_callback *callback,
 			   gpio_callback_handler_t handler)
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <logging/log.h>
+#include "gpio_ec.h"
+#include "gpio_ec_fast.h"
+#include "gpio_snapshot.h"
+
+LOG_MODULE_DECLARE(gpio_ec, CONFIG_GPIO_EC_LOG_LEVEL);
+
+#define SNAPSHOT_MAX_PINS	CONFIG_GPIO_SNAPSHOT_MAX_PINS
+
+BUILD_ASSERT(SNAPSHOT_MAX_PINS <= 32, "Monitored pins must fit in a mask");
+
+struct snapshot_pin {
+	uint16_t debounce_ms;
+	/* Uptime when sampled level started to differ from debounced one */
+	int64_t change_start;
+	struct gpio_callback gpio_cb;
+};
+
+static struct snapshot_pin pins[SNAPSHOT_MAX_PINS];
+/* Kept apart from pins so all pins can be sampled in a single call */
+static uint32_t port_pins[SNAPSHOT_MAX_PINS];
+static uint8_t pin_count;
+
+/* Debounced levels and changes reported by latest snapshot */
+static uint32_t levels;
+static uint32_t changed;
+/* Pins sampled at a level different from debounced one */
+static uint32_t pending;
+/* Pins without edge interrupt, only sampled on request */
+static uint32_t polled;
+/* Pins that failed to read in latest snapshot */
+static uint32_t failed;
+
+static sys_slist_t subs;
+static struct k_spinlock snapshot_lock;
+
+static void snapshot_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(snapshot_work, snapshot_work_handler);
+
+static void snapshot_take(uint32_t *chg, uint32_t *cur)
+{
+	uint8_t raw[SNAPSHOT_MAX_PINS];
+	k_spinlock_key_t key;
+	int64_t now;
+	uint32_t bit;
+	uint8_t count;
+
+	key = k_spin_lock(&snapshot_lock);
+	count = pin_count;
+	k_spin_unlock(&snapshot_lock, key);
+
+	gpio_read_pins(port_pins, raw, count);
+	now = k_uptime_get();
+
+	key = k_spin_lock(&snapshot_lock);
+	*chg = 0;
+	for (uint8_t i = 0; i < count; i++) {
+		bit = BIT(i);
+
+		/* Keep debounced level, debounce resumes on next good read */
+		if (raw[i] == GPIO_LEVEL_READ_FAILED) {
+			failed |= bit;
+			continue;
+		}
+		failed &= ~bit;
+
+		if (!raw[i] == !(levels & bit)) {
+			/* Glitch shorter than debounce time */
+			pending &= ~bit;
+			continue;
+		}
+
+		if (!(pending & bit)) {
+			pending |= bit;
+			pins[i].change_start = now;
+		}
+
+		if (now - pins[i].change_start >= pins[i].debounce_ms) {
+			pending &= ~bit;
+			levels ^= bit;
+			*chg |= bit;
+		}
+	}
+
+	changed = *chg;
+	*cur = levels;
+	k_spin_unlock(&snapshot_lock, key);
+}
+
+static void snapshot_work_handler(struct k_work *work)
+{
+	struct gpio_snapshot_sub *sub;
+	uint32_t chg;
+	uint32_t cur;
+
+	snapshot_take(&chg, &cur);
+
+	if (chg) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&subs, sub, node) {
+			if (sub->mask & chg) {
+				sub->handler(sub->mask & chg, cur);
+			}
+		}
+	}
+
+	/* Keep sampling only while a change is being debounced, pins without
+	 * edge interrupt are otherwise sampled when requested.
+	 */
+	if (pending) {
+		k_work_reschedule(&snapshot_work,
+				  K_MSEC(CONFIG_GPIO_SNAPSHOT_PERIOD_MS));
+	}
+}
+
+static void snapshot_gpio_handler(const struct device *dev,
+				  struct gpio_callback *gpio_cb, uint32_t pins)
+{
+	gpio_snapshot_request();
+}
+
+static int snapshot_find_pin(uint32_t port_pin)
+{
+	for (int i = 0; i < pin_count; i++) {
+		if (port_pins[i] == port_pin) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+int gpio_snapshot_add_pin(uint32_t port_pin, uint16_t debounce_ms)
+{
+	k_spinlock_key_t key;
+	struct snapshot_pin *pin;
+	int level;
+	int slot;
+	int ret;
+
+	level = gpio_fast_read_pin(port_pin);
+	if (level < 0) {
+		return level;
+	}
+
+	key = k_spin_lock(&snapshot_lock);
+	slot = snapshot_find_pin(port_pin);
+	if (slot >= 0) {
+		pins[slot].debounce_ms = MAX(pins[slot].debounce_ms,
+					     debounce_ms);
+		k_spin_unlock(&snapshot_lock, key);
+		return 0;
+	}
+
+	if (pin_count >= SNAPSHOT_MAX_PINS) {
+		k_spin_unlock(&snapshot_lock, key);
+		return -ENOMEM;
+	}
+
+	slot = pin_count;
+	pin = &pins[slot];
+	pin->debounce_ms = debounce_ms;
+	port_pins[slot] = port_pin;
+	WRITE_BIT(levels, slot, level);
+	pin_count++;
+	k_spin_unlock(&snapshot_lock, key);
+
+	ret = gpio_init_callback_pin(port_pin, &pin->gpio_cb,
+				     snapshot_gpio_handler);
+	if (!ret) {
+		ret = gpio_add_callback_pin(port_pin, &pin->gpio_cb);
+	}
+
+	if (!ret) {
+		ret = gpio_interrupt_configure_pin(port_pin,
+						   GPIO_INT_EDGE_BOTH);
+	}
+
+	if (ret) {
+		LOG_WRN("No edge event for %x, polling", port_pin);
+		key = k_spin_lock(&snapshot_lock);
+		polled |= BIT(slot);
+		k_spin_unlock(&snapshot_lock, key);
+		gpio_snapshot_request();
+	}
+
+	return 0;
+}
+
+uint32_t gpio_snapshot_pin_mask(uint32_t port_pin)
+{
+	k_spinlock_key_t key;
+	int slot;
+
+	key = k_spin_lock(&snapshot_lock);
+	slot = snapshot_find_pin(port_pin);
+	k_spin_unlock(&snapshot_lock, key);
+
+	return (slot < 0) ? 0 : BIT(slot);
+}
+
+void gpio_snapshot_subscribe(struct gpio_snapshot_sub *sub)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&snapshot_lock);
+	sys_slist_append(&subs, &sub->node);
+	k_spin_unlock(&snapshot_lock, key);
+}
+
+int gpio_snapshot_get(uint32_t port_pin)
+{
+	uint32_t mask = gpio_snapshot_pin_mask(port_pin);
+	k_spinlock_key_t key;
+	int ret;
+
+	if (!mask) {
+		return gpio_fast_read_pin(port_pin);
+	}
+
+	/* Pin without edge interrupt, sample it so a change gets debounced */
+	if (polled & mask) {
+		gpio_snapshot_request();
+	}
+
+	key = k_spin_lock(&snapshot_lock);
+	if (failed & mask) {
+		ret = -EIO;
+	} else {
+		ret = (levels & mask) ? 1 : 0;
+	}
+	k_spin_unlock(&snapshot_lock, key);
+
+	return ret;
+}
+
+uint32_t gpio_snapshot_levels(uint32_t *chg)
+{
+	k_spinlock_key_t key;
+	uint32_t cur;
+
+	key = k_spin_lock(&snapshot_lock);
+	cur = levels;
+	if (chg) {
+		*chg = changed;
+	}
+	k_spin_unlock(&snapshot_lock, key);
+
+	return cur;
+}
+
+void gpio_snapshot_request(void)
+{
+	k_work_reschedule(&snapshot_work, K_NO_WAIT);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __GPIO_SNAPSHOT_H__
+#define __GPIO_SNAPSHOT_H__
+
+#include <zephyr.h>
+#include <sys/slist.h>
+
+/**
+ * @brief Shared view of monitored platform signals.
+ *
+ * All monitored pins are sampled together, reading each GPIO port once,
+ * whenever a monitored pin edge interrupt occurs or a snapshot is requested,
+ * then at CONFIG_GPIO_SNAPSHOT_PERIOD_MS while a change is being debounced.
+ * Pins without edge interrupt, e.g. IO expander pins, are not polled
+ * otherwise. Every module reading a monitored pin then gets the
+ * same level for the same instant without accessing the hardware.
+ *
+ * Monitored pins are identified by a bit in 32-bit masks, see
+ * gpio_snapshot_pin_mask().
+ */
+
+/**
+ * @brief Handler notified of debounced level changes.
+ *
+ * Called from system workqueue context.
+ *
+ * @param changed mask of monitored pins whose level changed.
+ * @param levels debounced level of all monitored pins.
+ */
+typedef void (*gpio_snapshot_handler_t)(uint32_t changed, uint32_t levels);
+
+struct gpio_snapshot_sub {
+	sys_snode_t node;
+	/* Monitored pins of interest */
+	uint32_t mask;
+	gpio_snapshot_handler_t handler;
+};
+
+/**
+ * @brief Add a pin to the monitored signals.
+ *
+ * Adding an already monitored pin keeps a single slot, with the longest
+ * debounce time requested.
+ *
+ * @param port_pin Encoded port/pin.
+ * @param debounce_ms time the pin level needs to be stable before a change
+ * is reported, 0 to report any change sampled.
+ *
+ * @retval 0 if successful, -ENOMEM if no more pins can be monitored.
+ */
+int gpio_snapshot_add_pin(uint32_t port_pin, uint16_t debounce_ms);
+
+/**
+ * @brief Get the mask bit of a monitored pin.
+ *
+ * @param port_pin Encoded port/pin.
+ *
+ * @retval Mask with the pin bit set, 0 if pin is not monitored.
+ */
+uint32_t gpio_snapshot_pin_mask(uint32_t port_pin);
+
+/**
+ * @brief Register for level change notifications.
+ *
+ * @param sub subscriber, must remain valid while registered.
+ */
+void gpio_snapshot_subscribe(struct gpio_snapshot_sub *sub);
+
+/**
+ * @brief Get debounced level of a pin from the latest snapshot.
+ *
+ * Pins not monitored are read from hardware. Reading a monitored pin
+ * without edge interrupt requests a new snapshot, a change is reported once
+ * debounced.
+ *
+ * @param port_pin Encoded port/pin.
+ *
+ * @retval 1 if high, 0 if low, -EIO if pin failed to read in latest
+ * snapshot, negative errno code on failure.
+ */
+int gpio_snapshot_get(uint32_t port_pin);
+
+/**
+ * @brief Get debounced levels of all monitored pins.
+ *
+ * @param changed optional, mask of pins changed in the latest snapshot.
+ *
+ * @retval levels of all monitored pins.
+ */
+uint32_t gpio_snapshot_levels(uint32_t *changed);
+
+/**
+ * @brief Take a new snapshot as soon as possible.
+ *
+ * @note Can be called from ISR.
+ */
+void gpio_snapshot_request(void);
+
+#endif /* __GPIO_SNAPSHOT_H__ */
@@ -5,16 +5,28 @@
  */
 
 #include <zephyr/types.h>
+#include <kernel.h>
 #include <device.h>
 #include <drivers/i2c.h>
 #include "board_config.h"
+#include "i2c_hub.h"
 #include <logging/log.h>
 LOG_MODULE_REGISTER(i2c_hub, CONFIG_I2C_HUB_LOG_LEVEL);
 
+/* Bus threads only block on the I2C controller, run them above EC tasks so
+ * queued transactions are issued as soon as the bus is free.
+ */
+#define I2C_HUB_THREAD_PRIO	K_PRIO_COOP(4)
 
 struct i2c_hub_struct {
 	const struct device *device;
+	/* Held during transfers and bus reconfiguration */
 	struct k_mutex mutex;
+	struct k_spinlock lock;
+	sys_slist_t queue[I2C_HUB_PRIO_COUNT];
+	struct k_sem queued;
+	struct k_thread thread;
+	struct i2c_hub_dev_stats stats[CONFIG_I2C_HUB_STATS_DEVICES];
 };
 
 struct i2c_dev_inst {
@@ -46,6 +58,274 @@ static struct i2c_dev_inst i2c_inst[] = {
 
 static struct i2c_hub_struct i2c_dev[NUM_OF_I2C_BUS];
 
+K_THREAD_STACK_ARRAY_DEFINE(i2c_hub_stacks, NUM_OF_I2C_BUS,
+			    CONFIG_I2C_HUB_THREAD_STACK_SIZE);
+
+/* Must be called with bus lock held */
+static struct i2c_hub_dev_stats *i2c_hub_stats_entry(
+	struct i2c_hub_struct *bus, uint16_t addr)
+{
+	struct i2c_hub_dev_stats *stats;
+
+	for (int i = 0; i < ARRAY_SIZE(bus->stats); i++) {
+		stats = &bus->stats[i];
+		if (stats->txns == 0 && stats->merged == 0) {
+			/* First unused entry */
+			stats->addr = addr;
+			return stats;
+		}
+
+		if (stats->addr == addr) {
+			return stats;
+		}
+	}
+
+	return NULL;
+}
+
+static void i2c_hub_complete(struct i2c_hub_txn *txn, int status)
+{
+	i2c_hub_txn_cb_t cb = txn->cb;
+
+	txn->status = status;
+	txn->pending = false;
+
+	if (cb) {
+		cb(txn, status);
+	} else {
+		k_sem_give(&txn->done);
+	}
+}
+
+static struct i2c_hub_txn *i2c_hub_dequeue(struct i2c_hub_struct *bus)
+{
+	k_spinlock_key_t key = k_spin_lock(&bus->lock);
+	sys_snode_t *node = NULL;
+
+	for (int prio = 0; prio < I2C_HUB_PRIO_COUNT && !node; prio++) {
+		node = sys_slist_get(&bus->queue[prio]);
+	}
+
+	k_spin_unlock(&bus->lock, key);
+
+	return node ? CONTAINER_OF(node, struct i2c_hub_txn, node) : NULL;
+}
+
+static void i2c_hub_thread(void *p1, void *p2, void *p3)
+{
+	struct i2c_hub_struct *bus = p1;
+	struct i2c_hub_dev_stats *stats;
+	struct i2c_hub_txn *txn;
+	k_spinlock_key_t key;
+	uint32_t start, busy_us, bytes;
+	int ret;
+
+	while (true) {
+		k_sem_take(&bus->queued, K_FOREVER);
+
+		txn = i2c_hub_dequeue(bus);
+		if (!txn) {
+			continue;
+		}
+
+		k_mutex_lock(&bus->mutex, K_FOREVER);
+		start = k_cycle_get_32();
+		ret = i2c_transfer(bus->device, txn->msgs, txn->num_msgs,
+				   txn->addr);
+		busy_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+		k_mutex_unlock(&bus->mutex);
+
+		bytes = 0;
+		for (int i = 0; i < txn->num_msgs; i++) {
+			bytes += txn->msgs[i].len;
+		}
+
+		key = k_spin_lock(&bus->lock);
+		stats = i2c_hub_stats_entry(bus, txn->addr);
+		if (stats) {
+			stats->txns++;
+			stats->busy_us += busy_us;
+			if (ret) {
+				stats->naks++;
+			} else {
+				stats->bytes += bytes;
+			}
+		}
+		k_spin_unlock(&bus->lock, key);
+
+		i2c_hub_complete(txn, ret);
+	}
+}
+
+static bool i2c_hub_can_merge(const struct i2c_hub_txn *queued,
+			      const struct i2c_hub_txn *txn)
+{
+	return (queued->flags & I2C_HUB_TXN_MERGE) &&
+	       queued->addr == txn->addr &&
+	       queued->num_msgs == 1 &&
+	       !(queued->msgs[0].flags & I2C_MSG_READ) &&
+	       queued->msgs[0].len == txn->msgs[0].len &&
+	       queued->msgs[0].buf[0] == txn->msgs[0].buf[0];
+}
+
+void i2c_hub_txn_write(struct i2c_hub_txn *txn, uint16_t addr,
+		       const uint8_t *buf, uint32_t len)
+{
+	txn->addr = addr;
+	txn->msgs[0].buf = (uint8_t *)buf;
+	txn->msgs[0].len = len;
+	txn->msgs[0].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+	txn->num_msgs = 1;
+}
+
+void i2c_hub_txn_read(struct i2c_hub_txn *txn, uint16_t addr,
+		      uint8_t *buf, uint32_t len)
+{
+	txn->addr = addr;
+	txn->msgs[0].buf = buf;
+	txn->msgs[0].len = len;
+	txn->msgs[0].flags = I2C_MSG_READ | I2C_MSG_STOP;
+	txn->num_msgs = 1;
+}
+
+void i2c_hub_txn_write_read(struct i2c_hub_txn *txn, uint16_t addr,
+			    const void *wbuf, size_t wlen,
+			    void *rbuf, size_t rlen)
+{
+	txn->addr = addr;
+	txn->msgs[0].buf = (uint8_t *)wbuf;
+	txn->msgs[0].len = wlen;
+	txn->msgs[0].flags = I2C_MSG_WRITE;
+	txn->msgs[1].buf = rbuf;
+	txn->msgs[1].len = rlen;
+	txn->msgs[1].flags = I2C_MSG_RESTART | I2C_MSG_READ | I2C_MSG_STOP;
+	txn->num_msgs = 2;
+}
+
+int i2c_hub_submit(uint8_t instance, struct i2c_hub_txn *txn)
+{
+	struct i2c_hub_struct *bus;
+	struct i2c_hub_txn *queued, *replaced = NULL;
+	struct i2c_hub_dev_stats *stats;
+	sys_slist_t *queue;
+	sys_snode_t *prev = NULL;
+	k_spinlock_key_t key;
+
+	if (instance >= NUM_OF_I2C_BUS) {
+		return -ENODEV;
+	}
+	if (!i2c_dev[instance].device) {
+		return -ENODEV;
+	}
+	if (txn->prio >= I2C_HUB_PRIO_COUNT) {
+		return -EINVAL;
+	}
+
+	bus = &i2c_dev[instance];
+	queue = &bus->queue[txn->prio];
+
+	key = k_spin_lock(&bus->lock);
+
+	if (txn->pending) {
+		k_spin_unlock(&bus->lock, key);
+		return -EBUSY;
+	}
+
+	txn->pending = true;
+	k_sem_init(&txn->done, 0, 1);
+
+	if ((txn->flags & I2C_HUB_TXN_MERGE) && txn->num_msgs == 1 &&
+	    !(txn->msgs[0].flags & I2C_MSG_READ) && txn->msgs[0].len) {
+		SYS_SLIST_FOR_EACH_CONTAINER(queue, queued, node) {
+			if (i2c_hub_can_merge(queued, txn)) {
+				replaced = queued;
+				break;
+			}
+			prev = &queued->node;
+		}
+	}
+
+	if (replaced) {
+		/* Take over the queue position of the replaced write */
+		sys_slist_remove(queue, prev, &replaced->node);
+		sys_slist_insert(queue, prev, &txn->node);
+		stats = i2c_hub_stats_entry(bus, txn->addr);
+		if (stats) {
+			stats->merged++;
+		}
+	} else {
+		sys_slist_append(queue, &txn->node);
+	}
+
+	k_spin_unlock(&bus->lock, key);
+
+	if (replaced) {
+		/* Device ends with the same content as if both were issued */
+		i2c_hub_complete(replaced, 0);
+	} else {
+		k_sem_give(&bus->queued);
+	}
+
+	return 0;
+}
+
+int i2c_hub_txn_wait(struct i2c_hub_txn *txn, k_timeout_t timeout)
+{
+	if (k_sem_take(&txn->done, timeout)) {
+		return -EAGAIN;
+	}
+
+	return txn->status;
+}
+
+int i2c_hub_get_stats(uint8_t instance, uint16_t addr,
+		      struct i2c_hub_dev_stats *stats)
+{
+	struct i2c_hub_struct *bus;
+	k_spinlock_key_t key;
+	int ret = -ENOENT;
+
+	if (instance >= NUM_OF_I2C_BUS) {
+		return -ENODEV;
+	}
+
+	bus = &i2c_dev[instance];
+	key = k_spin_lock(&bus->lock);
+
+	for (int i = 0; i < ARRAY_SIZE(bus->stats); i++) {
+		if ((bus->stats[i].txns || bus->stats[i].merged) &&
+		    bus->stats[i].addr == addr) {
+			*stats = bus->stats[i];
+			ret = 0;
+			break;
+		}
+	}
+
+	k_spin_unlock(&bus->lock, key);
+
+	return ret;
+}
+
+/* Synchronous APIs go through the bus queue, so that they are ordered with
+ * asynchronous requests by priority.
+ */
+static int i2c_hub_run(uint8_t instance, struct i2c_hub_txn *txn)
+{
+	int ret;
+
+	txn->prio = I2C_HUB_PRIO_NORMAL;
+	txn->flags = 0;
+	txn->cb = NULL;
+	txn->pending = false;
+
+	ret = i2c_hub_submit(instance, txn);
+	if (ret) {
+		return ret;
+	}
+
+	return i2c_hub_txn_wait(txn, K_FOREVER);
+}
+
 
 int i2c_hub_config(uint8_t instance)
 {
@@ -70,7 +350,23 @@ int i2c_hub_config(uint8_t instance)
 		return ret;
 	}
 
+	/* Bus may be reconfigured, e.g. speed change, thread is kept */
+	if (i2c_dev[instance].device) {
+		return 0;
+	}
+
 	k_mutex_init(&i2c_dev[instance].mutex);
+	k_sem_init(&i2c_dev[instance].queued, 0, K_SEM_MAX_LIMIT);
+	for (int prio = 0; prio < I2C_HUB_PRIO_COUNT; prio++) {
+		sys_slist_init(&i2c_dev[instance].queue[prio]);
+	}
+
+	k_thread_create(&i2c_dev[instance].thread, i2c_hub_stacks[instance],
+			K_THREAD_STACK_SIZEOF(i2c_hub_stacks[instance]),
+			i2c_hub_thread, &i2c_dev[instance], NULL, NULL,
+			I2C_HUB_THREAD_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&i2c_dev[instance].thread, "i2c_hub");
+
 	i2c_dev[instance].device = dev;
 
 	return 0;
@@ -103,99 +399,63 @@ int i2c_hub_set_speed(uint8_t instance, uint8_t speed)
 int i2c_hub_write(uint8_t instance, const uint8_t *buf,
 		  uint32_t num_bytes, uint16_t addr)
 {
-	int ret;
-
-	if (instance >= NUM_OF_I2C_BUS) {
-		return -ENODEV;
-	}
-	if (!i2c_dev[instance].device) {
-		return -ENODEV;
-	}
+	struct i2c_hub_txn txn;
 
-	k_mutex_lock(&i2c_dev[instance].mutex, K_FOREVER);
-	ret = i2c_write(i2c_dev[instance].device, buf, num_bytes, addr);
-	k_mutex_unlock(&i2c_dev[instance].mutex);
+	i2c_hub_txn_write(&txn, addr, buf, num_bytes);
 
-	return ret;
+	return i2c_hub_run(instance, &txn);
 }
 
 int i2c_hub_read(uint8_t instance, uint8_t *buf,
 		  uint32_t num_bytes, uint16_t addr)
 {
-	int ret;
+	struct i2c_hub_txn txn;
 
-	if (instance >= NUM_OF_I2C_BUS) {
-		return -ENODEV;
-	}
-	if (!i2c_dev[instance].device) {
-		return -ENODEV;
-	}
+	i2c_hub_txn_read(&txn, addr, buf, num_bytes);
 
-	k_mutex_lock(&i2c_dev[instance].mutex, K_FOREVER);
-	ret = i2c_read(i2c_dev[instance].device, buf, num_bytes, addr);
-	k_mutex_unlock(&i2c_dev[instance].mutex);
-
-	return ret;
+	return i2c_hub_run(instance, &txn);
 }
 
 int i2c_hub_write_read(uint8_t instance, uint16_t addr, const void *write_buf,
 		       size_t num_write, void *read_buf, size_t num_read)
 {
-	int ret;
+	struct i2c_hub_txn txn;
 
-	if (instance >= NUM_OF_I2C_BUS) {
-		return -ENODEV;
-	}
-	if (!i2c_dev[instance].device) {
-		return -ENODEV;
-	}
+	i2c_hub_txn_write_read(&txn, addr, write_buf, num_write,
+			       read_buf, num_read);
 
-	k_mutex_lock(&i2c_dev[instance].mutex, K_FOREVER);
-	ret = i2c_write_read(i2c_dev[instance].device, addr, write_buf,
-			     num_write, read_buf, num_read);
-	k_mutex_unlock(&i2c_dev[instance].mutex);
-
-	return ret;
+	return i2c_hub_run(instance, &txn);
 }
 
 int i2c_hub_burst_read(uint8_t instance, uint16_t dev_addr,
 		  uint8_t reg_addr, uint8_t *value, uint32_t len)
 {
-	int ret;
-
-	if (instance >= NUM_OF_I2C_BUS) {
-		return -ENODEV;
-	}
-	if (!i2c_dev[instance].device) {
-		return -ENODEV;
-	}
+	struct i2c_hub_txn txn;
 
-	k_mutex_lock(&i2c_dev[instance].mutex, K_FOREVER);
-	ret = i2c_burst_read(i2c_dev[instance].device, dev_addr,
-				reg_addr, value, len);
-	k_mutex_unlock(&i2c_dev[instance].mutex);
+	txn.reg = reg_addr;
+	i2c_hub_txn_write_read(&txn, dev_addr, &txn.reg, sizeof(txn.reg),
+			       value, len);
 
-	return ret;
+	return i2c_hub_run(instance, &txn);
 }
 
 int i2c_hub_burst_write(uint8_t instance, uint16_t dev_addr,
 		  uint8_t reg_addr, uint8_t *value, uint32_t len)
 {
-	int ret;
-
-	if (instance >= NUM_OF_I2C_BUS) {
-		return -ENODEV;
-	}
-	if (!i2c_dev[instance].device) {
-		return -ENODEV;
-	}
-
-	k_mutex_lock(&i2c_dev[instance].mutex, K_FOREVER);
-	ret = i2c_burst_write(i2c_dev[instance].device, dev_addr,
-				reg_addr, value, len);
-	k_mutex_unlock(&i2c_dev[instance].mutex);
-
-	return ret;
+	struct i2c_hub_txn txn;
+
+	/* Register address and data are sent back to back, no restart */
+	txn.reg = reg_addr;
+	txn.addr = dev_addr;
+	txn.msgs[0].buf = &txn.reg;
+	txn.msgs[0].len = sizeof(txn.reg);
+	txn.msgs[0].flags = I2C_MSG_WRITE;
+	txn.msgs[1].buf = value;
+	txn.msgs[1].len = len;
+	txn.msgs[1].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+	txn.num_msgs = 2;
+
+	return i2c_hub_run(instance, &txn);
 }
 
 int i2c_hub_slave_register(uint8_t instance, struct i2c_slave_config *cfg)
@@ -8,6 +8,7 @@
 #define I2C_HUB_H_
 
 #include <zephyr/types.h>
+#include <kernel.h>
 #include <device.h>
 #include <drivers/i2c.h>
 
@@ -19,6 +20,163 @@ enum i2c_bus_num {
 	I2C_4,
 };
 
+/**
+ * @brief I2C transaction priorities, highest first.
+ *
+ * Queued transactions on a bus are issued in priority order, FIFO within
+ * a priority.
+ */
+enum i2c_hub_prio {
+	/* Power critical requests */
+	I2C_HUB_PRIO_HIGH,
+	/* Default for synchronous APIs */
+	I2C_HUB_PRIO_NORMAL,
+	/* Informational requests, e.g. postcode display */
+	I2C_HUB_PRIO_LOW,
+	I2C_HUB_PRIO_COUNT,
+};
+
+/* A queued write to the same device and register, with the same length,
+ * is replaced by this transaction. Only for single message writes where
+ * the last value written matters, e.g. display updates.
+ */
+#define I2C_HUB_TXN_MERGE	BIT(0)
+
+struct i2c_hub_txn;
+
+/**
+ * @brief Transaction completion callback.
+ *
+ * Called from bus thread, or from i2c_hub_submit() when the transaction
+ * is replaced by a merged write. Must not call synchronous I2C hub APIs.
+ *
+ * @param txn completed transaction, may be submitted again.
+ * @param status 0 if successful, negative errno otherwise.
+ */
+typedef void (*i2c_hub_txn_cb_t)(struct i2c_hub_txn *txn, int status);
+
+/**
+ * @brief I2C transaction, storage owned by the submitter.
+ *
+ * Use the i2c_hub_txn_* helpers to describe the transfer, then set prio,
+ * flags, and optionally callback before submission. Without callback,
+ * completion is waited with i2c_hub_txn_wait().
+ */
+struct i2c_hub_txn {
+	sys_snode_t node;
+	uint16_t addr;
+	uint8_t prio;
+	uint8_t flags;
+	i2c_hub_txn_cb_t cb;
+	void *user_data;
+	/* Private, set by helpers and bus thread */
+	struct i2c_msg msgs[2];
+	uint8_t num_msgs;
+	uint8_t reg;
+	bool pending;
+	int status;
+	struct k_sem done;
+};
+
+/**
+ * @brief Per device I2C traffic counters.
+ */
+struct i2c_hub_dev_stats {
+	uint16_t addr;
+	uint32_t txns;
+	/* Bytes transferred in both directions, excluding address */
+	uint32_t bytes;
+	/* Transactions failed, mostly NAKs */
+	uint32_t naks;
+	/* Queued writes replaced by a later one */
+	uint32_t merged;
+	/* Time spent transferring, in us */
+	uint64_t busy_us;
+};
+
+/**
+ * @brief Describe a write transaction.
+ *
+ * @param txn transaction.
+ * @param addr I2C device address.
+ * @param buf data to write, must remain valid until completion.
+ * @param len number of bytes to write.
+ */
+void i2c_hub_txn_write(struct i2c_hub_txn *txn, uint16_t addr,
+		       const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Describe a read transaction.
+ *
+ * @param txn transaction.
+ * @param addr I2C device address.
+ * @param buf buffer for read data.
+ * @param len number of bytes to read.
+ */
+void i2c_hub_txn_read(struct i2c_hub_txn *txn, uint16_t addr,
+		      uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Describe a write followed by a read after a repeated start.
+ *
+ * @param txn transaction.
+ * @param addr I2C device address.
+ * @param wbuf data to write, must remain valid until completion.
+ * @param wlen number of bytes to write.
+ * @param rbuf buffer for read data.
+ * @param rlen number of bytes to read.
+ */
+void i2c_hub_txn_write_read(struct i2c_hub_txn *txn, uint16_t addr,
+			    const void *wbuf, size_t wlen,
+			    void *rbuf, size_t rlen);
+
+/**
+ * @brief Queue a transaction on a bus.
+ *
+ * @param instance I2C port number.
+ * @param txn transaction, must not be pending.
+ *
+ * @retval 0 if queued.
+ * @retval -ENODEV if bus is not configured.
+ * @retval -EBUSY if transaction is already pending.
+ */
+int i2c_hub_submit(uint8_t instance, struct i2c_hub_txn *txn);
+
+/**
+ * @brief Wait for a transaction submitted without callback to complete.
+ *
+ * @param txn transaction.
+ * @param timeout waiting period.
+ *
+ * @retval transaction status if completed.
+ * @retval -EAGAIN if transaction did not complete in time.
+ */
+int i2c_hub_txn_wait(struct i2c_hub_txn *txn, k_timeout_t timeout);
+
+/**
+ * @brief Check if a transaction is queued or in progress.
+ *
+ * @param txn transaction.
+ *
+ * @retval true if transaction is pending.
+ */
+static inline bool i2c_hub_txn_pending(const struct i2c_hub_txn *txn)
+{
+	return txn->pending;
+}
+
+/**
+ * @brief Get I2C traffic counters for a device.
+ *
+ * @param instance I2C port number.
+ * @param addr I2C device address.
+ * @param stats counters since boot.
+ *
+ * @retval 0 if successful, -ENOENT if device was never accessed.
+ */
+int i2c_hub_get_stats(uint8_t instance, uint16_t addr,
+		      struct i2c_hub_dev_stats *stats);
+
 /**
  * @brief Set up the i2c controller
  *
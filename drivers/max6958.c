@@ -35,6 +35,13 @@ LOG_MODULE_REGISTER(max6958, CONFIG_MAX6958_LOG_LEVEL);
 
 #define MAX6958_SCAN_MASK	0x07
 
+static void display_done(struct i2c_hub_txn *txn, int status)
+{
+	if (status) {
+		LOG_ERR("Failed to update display: %d", status);
+	}
+}
+
 int max6958_set_decode_mode(uint8_t mode_mask)
 {
 	uint8_t data[] = { MAX6958_DECODE_MODE, mode_mask };
@@ -74,16 +81,42 @@ int max6958_set_power(bool power)
 				MAX6958_9SEG_DISP_DRIVER_I2C_ADDR);
 }
 
+/* Display updates are queued at lowest priority, a queued update is
+ * replaced by a newer one. One may be in progress, one queued and one being
+ * submitted.
+ */
+#define MAX6958_DISPLAY_TXNS	3
+
+static struct i2c_hub_txn display_txn[MAX6958_DISPLAY_TXNS];
+static uint8_t display_data[MAX6958_DISPLAY_TXNS][5];
+
 int max6958_display_digits(uint32_t value)
 {
-	uint8_t data[] = { MAX6958_DIGIT0, 0, 0, 0, 0 };
-
-	/* Copy bytes from msb to lsb */
-	data[1] = (value & 0xF000) >> 12;
-	data[2] = (value & 0xF00) >> 8;
-	data[3] = (value & 0xF0) >> 4;
-	data[4] = (value & 0x0F);
+	struct i2c_hub_txn *txn;
+	uint8_t *data;
+
+	for (int i = 0; i < MAX6958_DISPLAY_TXNS; i++) {
+		txn = &display_txn[i];
+		if (i2c_hub_txn_pending(txn)) {
+			continue;
+		}
+
+		data = display_data[i];
+		data[0] = MAX6958_DIGIT0;
+		/* Copy bytes from msb to lsb */
+		data[1] = (value & 0xF000) >> 12;
+		data[2] = (value & 0xF00) >> 8;
+		data[3] = (value & 0xF0) >> 4;
+		data[4] = (value & 0x0F);
+
+		i2c_hub_txn_write(txn, MAX6958_9SEG_DISP_DRIVER_I2C_ADDR,
+				  data, sizeof(display_data[i]));
+		txn->prio = I2C_HUB_PRIO_LOW;
+		txn->flags = I2C_HUB_TXN_MERGE;
+		txn->cb = display_done;
+
+		return i2c_hub_submit(I2C_0, txn);
+	}
 
-	return i2c_hub_write(I2C_0, data, sizeof(data),
-				MAX6958_9SEG_DISP_DRIVER_I2C_ADDR);
+	return -EBUSY;
 }
@@ -67,9 +67,13 @@ int max6958_set_power(bool power);
 /**
  * @brief Display digits.
  *
+ * Display is updated asynchronously, an update not yet issued is replaced
+ * by the next one.
+ *
  * @param data the digits to display 3-0.
  *
- * @retval -EIO General input / output error, failed to configure device.
+ * @retval 0 if update is queued.
+ * @retval -EBUSY if too many updates are pending.
  *
  */
 int max6958_display_digits(uint32_t digits);
@@ -105,10 +105,37 @@ struct espi_oob_peci_resp_msg {
 	uint8_t data[PECI_DATA_BUF_LEN_MAX];
 } __packed;
 
+/* PECI revision is reported in upper nibble of DIB revision byte */
+#define PECI_DIB_REV_MAJOR(rev)	((rev) >> 4)
+#define PECI_REV_3		3u
+
+/* Cached PECI device information, valid until next platform reset or
+ * power state change.
+ */
+struct peci_dev_ctx {
+	uint8_t addr;
+	bool dib_valid;
+	bool tjmax_valid;
+	uint8_t dev_info;
+	uint8_t rev_num;
+	uint8_t tjmax;
+	uint32_t cmd_set;
+	uint32_t cmd_warned;
+	uint8_t fail_cnt;
+	int64_t retry_time;
+};
+
 static const struct device *peci_dev;
 static bool peci_initialized;
-static uint8_t cpu_tjmax;
-static uint8_t gpu_tjmax;
+static struct peci_dev_ctx peci_ctx[] = {
+	[CPU] = { .addr = PECI_CPU_ADDR },
+	[GPU] = { .addr = PECI_GPU_ADDR },
+};
+
+/* Incremented on every invalidation so that information fetched across an
+ * invalidation is discarded.
+ */
+static uint32_t peci_ctx_gen;
 
 /* Initialising  to POE as default mode */
 uint8_t peci_access_mode = PECI_OVER_ESPI_MODE;
@@ -166,6 +193,27 @@ static inline uint8_t get_peci_address(enum peci_devices dev)
 	}
 }
 
+/* DIB only reports the PECI revision, command set is derived from it and
+ * may be wrong for a given part. Command is always sent, unexpected ones are
+ * only reported once per DIB read.
+ */
+static void peci_ctx_note_cmd(enum peci_devices dev, uint32_t cmd)
+{
+	struct peci_dev_ctx *ctx;
+
+	if (dev >= ARRAY_SIZE(peci_ctx)) {
+		return;
+	}
+
+	ctx = &peci_ctx[dev];
+	if (ctx->dib_valid && !(ctx->cmd_set & cmd) &&
+	    !(ctx->cmd_warned & cmd)) {
+		ctx->cmd_warned |= cmd;
+		LOG_WRN("PECI %x rev %x may not support cmd %x", ctx->addr,
+			ctx->rev_num, cmd);
+	}
+}
+
 #ifdef CONFIG_DEPRECATED_HW_STRAP_BASED_PECI_MODE_SEL
 static void detect_peci_over_espi_mode(void)
 {
@@ -571,6 +619,8 @@ int peci_rdpkg_config(enum peci_devices dev, uint8_t *req_buf,
 	struct peci_msg packet;
 	uint8_t address = get_peci_address(dev);
 
+	peci_ctx_note_cmd(dev, PECI_CMDSET_RD_PKG_CFG);
+
 	packet.tx_buffer.buf = req_buf;
 	packet.tx_buffer.len = PECI_RD_PKG_WR_LEN;
 	packet.rx_buffer.buf = resp_buf;
@@ -616,6 +666,8 @@ int peci_rd_ia_msr(enum peci_devices dev, uint8_t *req_buf,
 	struct peci_msg packet;
 	uint8_t address = get_peci_address(dev);
 
+	peci_ctx_note_cmd(dev, PECI_CMDSET_RD_IAMSR);
+
 	packet.tx_buffer.buf = req_buf;
 	packet.tx_buffer.len = PECI_RD_IAMSR_WR_LEN;
 	packet.rx_buffer.buf = resp_buf;
@@ -639,6 +691,8 @@ int peci_wr_ia_msr(enum peci_devices dev, uint8_t *req_buf,
 	struct peci_msg packet;
 	uint8_t address = get_peci_address(dev);
 
+	peci_ctx_note_cmd(dev, PECI_CMDSET_WR_IAMSR);
+
 	packet.tx_buffer.buf = req_buf;
 	packet.tx_buffer.len = wr_len;
 	packet.rx_buffer.buf = resp_buf;
@@ -657,7 +711,8 @@ int peci_wr_ia_msr(enum peci_devices dev, uint8_t *req_buf,
 	return ret;
 }
 
-int peci_get_dib(enum peci_devices dev, uint8_t *dev_info, uint8_t *rev_num)
+static int peci_fetch_dib(enum peci_devices dev, uint8_t *dev_info,
+			  uint8_t *rev_num)
 {
 	int ret;
 	uint8_t req_buf[PECI_GET_DIB_WR_LEN + PECI_FCS_LEN];
@@ -684,8 +739,7 @@ int peci_get_dib(enum peci_devices dev, uint8_t *dev_info, uint8_t *rev_num)
 	return ret;
 }
 
-
-int peci_get_tjmax(enum peci_devices dev, uint8_t *tjmax)
+static int peci_fetch_tjmax(enum peci_devices dev, uint8_t *tjmax)
 {
 	int ret;
 
@@ -697,13 +751,155 @@ int peci_get_tjmax(enum peci_devices dev, uint8_t *tjmax)
 	};
 
 	ret = peci_rdpkg_config(dev, req_buf, resp_buf, PECI_RD_PKG_LEN_DWORD);
+	if (ret) {
+		return ret;
+	}
+
+	*tjmax = resp_buf[PECI_RX_BUF_TJMAX_OFFSET];
+	LOG_DBG("TjMax=%d", *tjmax);
+
+	return 0;
+}
 
-	if (!ret) {
-		*tjmax = resp_buf[PECI_RX_BUF_TJMAX_OFFSET];
+static void peci_ctx_set_dib(struct peci_dev_ctx *ctx, uint8_t dev_info,
+			     uint8_t rev_num)
+{
+	ctx->dev_info = dev_info;
+	ctx->rev_num = rev_num;
+	ctx->cmd_set = PECI_CMDSET_PING | PECI_CMDSET_GET_DIB |
+		       PECI_CMDSET_GET_TEMP | PECI_CMDSET_RD_PKG_CFG |
+		       PECI_CMDSET_WR_PKG_CFG | PECI_CMDSET_RD_IAMSR;
+
+	if (PECI_DIB_REV_MAJOR(rev_num) >= PECI_REV_3) {
+		ctx->cmd_set |= PECI_CMDSET_WR_IAMSR | PECI_CMDSET_RD_PCI_CFG |
+				PECI_CMDSET_WR_PCI_CFG;
 	}
 
-	LOG_INF("TjMax=%d", *tjmax);
-	return ret;
+	ctx->cmd_warned = 0;
+	ctx->dib_valid = true;
+}
+
+/**
+ * @brief Populate PECI device context.
+ *
+ * DIB is best effort since it only restricts the command set, TjMax is
+ * mandatory to report temperature. Failed attempts are retried with an
+ * exponential backoff so that a host going through reset is not flooded.
+ *
+ * @param dev PECI device.
+ * @retval 0 if TjMax is available, failure code otherwise.
+ */
+static int peci_ctx_refresh(enum peci_devices dev)
+{
+	struct peci_dev_ctx *ctx = &peci_ctx[dev];
+	uint32_t gen = peci_ctx_gen;
+	uint32_t backoff;
+	uint8_t dev_info;
+	uint8_t rev_num;
+	uint8_t tjmax;
+	int ret;
+
+	if (ctx->tjmax_valid) {
+		return 0;
+	}
+
+	if (k_uptime_get() < ctx->retry_time) {
+		return -EAGAIN;
+	}
+
+	if (!ctx->dib_valid) {
+		ret = peci_fetch_dib(dev, &dev_info, &rev_num);
+		/* Transfers may block, drop result if context was reset */
+		if (!ret && gen == peci_ctx_gen) {
+			peci_ctx_set_dib(ctx, dev_info, rev_num);
+		}
+	}
+
+	ret = peci_fetch_tjmax(dev, &tjmax);
+	if (gen != peci_ctx_gen) {
+		return -EAGAIN;
+	}
+
+	if (ret) {
+		backoff = MIN(CONFIG_PECIHUB_CTX_RETRY_MAX_MS,
+			      CONFIG_PECIHUB_CTX_RETRY_MIN_MS << ctx->fail_cnt);
+		ctx->retry_time = k_uptime_get() + backoff;
+		if (backoff < CONFIG_PECIHUB_CTX_RETRY_MAX_MS) {
+			ctx->fail_cnt++;
+		}
+		LOG_WRN("PECI %x TjMax unavailable, retry in %d ms",
+			ctx->addr, backoff);
+		return ret;
+	}
+
+	ctx->tjmax = tjmax;
+	ctx->tjmax_valid = true;
+	ctx->fail_cnt = 0;
+	LOG_INF("PECI %x DIB %x rev %x TjMax %d", ctx->addr,
+		ctx->dev_info, ctx->rev_num, ctx->tjmax);
+
+	return 0;
+}
+
+void peci_invalidate_cache(void)
+{
+	LOG_DBG("%s", __func__);
+
+	peci_ctx_gen++;
+	for (int i = 0; i < ARRAY_SIZE(peci_ctx); i++) {
+		peci_ctx[i].dib_valid = false;
+		peci_ctx[i].tjmax_valid = false;
+		peci_ctx[i].fail_cnt = 0;
+		peci_ctx[i].retry_time = 0;
+	}
+}
+
+int peci_get_dib(enum peci_devices dev, uint8_t *dev_info, uint8_t *rev_num)
+{
+	struct peci_dev_ctx *ctx;
+	uint32_t gen = peci_ctx_gen;
+	int ret;
+
+	if (dev >= ARRAY_SIZE(peci_ctx)) {
+		return -EINVAL;
+	}
+
+	ctx = &peci_ctx[dev];
+	if (!ctx->dib_valid) {
+		ret = peci_fetch_dib(dev, dev_info, rev_num);
+		if (ret) {
+			return ret;
+		}
+
+		if (gen == peci_ctx_gen) {
+			peci_ctx_set_dib(ctx, *dev_info, *rev_num);
+		}
+
+		return 0;
+	}
+
+	*dev_info = ctx->dev_info;
+	*rev_num = ctx->rev_num;
+
+	return 0;
+}
+
+int peci_get_tjmax(enum peci_devices dev, uint8_t *tjmax)
+{
+	int ret;
+
+	if (dev >= ARRAY_SIZE(peci_ctx)) {
+		return -EINVAL;
+	}
+
+	ret = peci_ctx_refresh(dev);
+	if (ret) {
+		return ret;
+	}
+
+	*tjmax = peci_ctx[dev].tjmax;
+
+	return 0;
 }
 
 int peci_get_temp(enum peci_devices dev, int *temperature)
@@ -713,35 +909,19 @@ int peci_get_temp(enum peci_devices dev, int *temperature)
 	int ret;
 	struct peci_msg packet;
 	uint8_t tjmax;
-	uint8_t *tjmax_ptr;
 	uint8_t address = get_peci_address(dev);
 
-	switch (dev) {
-	case CPU:
-		tjmax_ptr = &cpu_tjmax;
-		break;
-
-	case GPU:
-		tjmax_ptr = &gpu_tjmax;
-		break;
-
-	default:
-		LOG_ERR("Unknown PECI device: %d", dev);
-		return -EINVAL;
-	}
-
 	/* If cpu/gpu tjmax is not fetched then cpu/gpu temperature cannot
 	 * be calculated. In this case return fail safe temperature.
 	 */
-	if (*tjmax_ptr == 0) {
-		ret = peci_get_tjmax(dev, tjmax_ptr);
-		if (ret) {
+	ret = peci_get_tjmax(dev, &tjmax);
+	if (ret) {
+		if (ret != -EAGAIN) {
 			LOG_ERR("Fail to get CPU/GPU TjMax: %d", ret);
-			*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
-			return -EINVAL;
 		}
+		*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
+		return -EINVAL;
 	}
-	tjmax = *tjmax_ptr;
 
 	uint8_t resp_buf[PECI_GET_TEMP_RD_LEN + PECI_FCS_LEN];
 
@@ -833,7 +1013,6 @@ int peci_init(void)
 	LOG_INF("Peci init success");
 
 	peci_initialized = true;
-	cpu_tjmax = 0;
-	gpu_tjmax = 0;
+	peci_invalidate_cache();
 	return 0;
 }
@@ -32,6 +32,30 @@ enum peci_devices {
 	GPU,
 };
 
+/* PECI commands expected to be supported, as derived from DIB revision */
+#define PECI_CMDSET_PING		BIT(0)
+#define PECI_CMDSET_GET_DIB		BIT(1)
+#define PECI_CMDSET_GET_TEMP		BIT(2)
+#define PECI_CMDSET_RD_PKG_CFG		BIT(3)
+#define PECI_CMDSET_WR_PKG_CFG		BIT(4)
+#define PECI_CMDSET_RD_IAMSR		BIT(5)
+#define PECI_CMDSET_WR_IAMSR		BIT(6)
+#define PECI_CMDSET_RD_PCI_CFG		BIT(7)
+#define PECI_CMDSET_WR_PCI_CFG		BIT(8)
+
+/**
+ * @brief Invalidate cached PECI device information.
+ *
+ * DIB, revision, TjMax and supported command set are cached per PECI device
+ * after first successful read. This must be called whenever the host may
+ * have been reset, i.e. PLTRST# changes or system power state transitions.
+ */
+#ifdef CONFIG_THERMAL_MANAGEMENT
+void peci_invalidate_cache(void);
+#else
+static inline void peci_invalidate_cache(void) {}
+#endif
+
 /**
  * @brief Get CPU temperature.
  *
@@ -46,9 +70,10 @@ int peci_get_temp(enum peci_devices dev, int *temperature);
  * @brief Get CPU maximum junction temperature.
  *
  * This function fetches maximum cpu core juntion
- * temperature using peci.
+ * temperature using peci. Value is cached until peci_invalidate_cache().
  *
  * @param *tjmax address of temperature variable.
+ * @retval -EAGAIN if a previous attempt failed and retry is delayed.
  * @retval 0 on success and failure code on error.
  */
 int peci_get_tjmax(enum peci_devices dev, uint8_t *tjmax);
@@ -108,6 +133,7 @@ int peci_wr_ia_msr(enum peci_devices dev, uint8_t *req_buf,
  * @brief Read DIB.
  *
  * This function fetches Device Information Byte (DIB) using peci.
+ * Value is cached until peci_invalidate_cache().
  *
  * @param *dev_info device information byte.
  * @param *rev_num revision number byte.
@@ -23,6 +23,8 @@
 #define WRITE_ENABLE_VS_OPCODE         0x50U
 #define POWER_DOWN                     0xB9U
 #define RELEASE_POWER_DOWN             0xABU
+#define READ_JEDEC_ID_OPCODE           0x9FU
+#define READ_SFDP_OPCODE               0x5AU
 
 #define READ_VOLATILE_CFG_OPCODE       0x85U
 #define WRITE_VOLATILE_CFG_OPCODE      0x81U
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <sys/crc.h>
+#include <sys/byteorder.h>
+#include <logging/log.h>
+#include "eeprom.h"
+#include "ec_settings.h"
+
+LOG_MODULE_REGISTER(ec_settings, CONFIG_EC_SETTINGS_LOG_LEVEL);
+
+/* Settings area is split in sectors used as a ring. Records are appended
+ * to the active sector, once full the live settings are written to the
+ * next sector with a newer generation. Every sector is written in turn,
+ * spreading wear across the whole area.
+ *
+ * Sector: magic (2) | generation (2) | crc (2) | records...
+ * Record: key (1) | len (1) | value (len) | crc (2)
+ *
+ * Record CRC covers the sector generation, so records left over from a
+ * previous use of the sector are not valid. Log ends at first erased or
+ * invalid record, e.g. a record interrupted by a power loss.
+ */
+#define SETTINGS_BASE		CONFIG_EC_SETTINGS_EEPROM_OFFSET
+#define SECTOR_SIZE		CONFIG_EC_SETTINGS_SECTOR_SIZE
+#define SECTORS			CONFIG_EC_SETTINGS_SECTORS
+#define MAX_KEYS		CONFIG_EC_SETTINGS_MAX_KEYS
+
+#define SECTOR_MAGIC		0x5345
+#define SECTOR_HDR_SIZE		6u
+#define REC_OVERHEAD		4u
+#define REC_SIZE(len)		(REC_OVERHEAD + (len))
+
+#define KEY_ERASED		0xFFu
+#define KEY_INVALID		0x00u
+
+#define SECTOR_OFS(sector)	(SETTINGS_BASE + ((sector) * SECTOR_SIZE))
+
+BUILD_ASSERT(SECTOR_SIZE % CONFIG_EEPROM_PAGE_SIZE == 0,
+	     "Settings sectors must be aligned to EEPROM pages");
+BUILD_ASSERT(SETTINGS_BASE + (SECTORS * SECTOR_SIZE) <= CONFIG_EEPROM_SIZE,
+	     "Settings area exceeds EEPROM size");
+BUILD_ASSERT(MAX_KEYS * REC_SIZE(EC_SETTINGS_VAL_MAX) <=
+	     SECTOR_SIZE - SECTOR_HDR_SIZE,
+	     "All settings must fit in a sector");
+
+struct ec_setting {
+	uint8_t key;
+	uint8_t len;
+	uint8_t val[EC_SETTINGS_VAL_MAX];
+};
+
+static struct ec_setting cache[MAX_KEYS];
+static uint8_t cache_count;
+
+static bool loaded;
+static uint8_t active;
+static uint16_t generation;
+/* Next free offset in active sector */
+static uint16_t write_ofs;
+
+/* Whole settings area at boot, then used to build sectors on compaction */
+static uint8_t area[SECTORS * SECTOR_SIZE];
+
+K_MUTEX_DEFINE(settings_mutex);
+
+static uint16_t rec_crc(uint16_t gen, const uint8_t *rec, uint8_t len)
+{
+	uint8_t gen_le[sizeof(gen)];
+
+	sys_put_le16(gen, gen_le);
+
+	return crc16_ccitt(crc16_ccitt(0xFFFF, gen_le, sizeof(gen_le)),
+			   rec, len);
+}
+
+static struct ec_setting *cache_find(uint8_t key)
+{
+	for (uint8_t i = 0; i < cache_count; i++) {
+		if (cache[i].key == key) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static uint16_t rec_build(uint8_t *buf, const struct ec_setting *set)
+{
+	buf[0] = set->key;
+	buf[1] = set->len;
+	memcpy(&buf[2], set->val, set->len);
+	sys_put_le16(rec_crc(generation, buf, 2 + set->len),
+		     &buf[2 + set->len]);
+
+	return REC_SIZE(set->len);
+}
+
+static bool sector_valid(const uint8_t *sector, uint16_t *gen)
+{
+	if (sys_get_le16(sector) != SECTOR_MAGIC ||
+	    sys_get_le16(&sector[4]) != crc16_ccitt(0xFFFF, sector, 4)) {
+		return false;
+	}
+
+	*gen = sys_get_le16(&sector[2]);
+
+	return true;
+}
+
+static void sector_load(const uint8_t *sector)
+{
+	struct ec_setting *set;
+	uint16_t ofs = SECTOR_HDR_SIZE;
+	uint8_t key, len;
+
+	while (ofs + REC_OVERHEAD <= SECTOR_SIZE) {
+		key = sector[ofs];
+		len = sector[ofs + 1];
+
+		if (key == KEY_ERASED || key == KEY_INVALID ||
+		    len > EC_SETTINGS_VAL_MAX ||
+		    ofs + REC_SIZE(len) > SECTOR_SIZE ||
+		    sys_get_le16(&sector[ofs + 2 + len]) !=
+		    rec_crc(generation, &sector[ofs], 2 + len)) {
+			break;
+		}
+
+		/* Later records supersede earlier ones */
+		set = cache_find(key);
+		if (!set && cache_count < MAX_KEYS) {
+			set = &cache[cache_count++];
+		}
+
+		if (set) {
+			set->key = key;
+			set->len = len;
+			memcpy(set->val, &sector[ofs + 2], len);
+		} else {
+			LOG_WRN("Dropping setting %x", key);
+		}
+
+		ofs += REC_SIZE(len);
+	}
+
+	write_ofs = ofs;
+}
+
+/* Write all live settings to next sector, header is written last so the
+ * current sector stays active until the new one is complete.
+ */
+static int compact(void)
+{
+	uint8_t next = (active + 1) % SECTORS;
+	uint16_t gen = generation + 1;
+	uint16_t ofs = SECTOR_HDR_SIZE;
+	int ret;
+
+	generation = gen;
+	for (uint8_t i = 0; i < cache_count; i++) {
+		ofs += rec_build(&area[ofs], &cache[i]);
+	}
+
+	ret = eeprom_write(SECTOR_OFS(next) + SECTOR_HDR_SIZE,
+			   &area[SECTOR_HDR_SIZE], ofs - SECTOR_HDR_SIZE);
+	if (ret) {
+		generation = gen - 1;
+		return ret;
+	}
+
+	sys_put_le16(SECTOR_MAGIC, area);
+	sys_put_le16(gen, &area[2]);
+	sys_put_le16(crc16_ccitt(0xFFFF, area, 4), &area[4]);
+	ret = eeprom_write(SECTOR_OFS(next), area, SECTOR_HDR_SIZE);
+	if (ret) {
+		generation = gen - 1;
+		return ret;
+	}
+
+	LOG_DBG("Compacted into sector %d gen %d", next, gen);
+	active = next;
+	write_ofs = ofs;
+
+	return 0;
+}
+
+int ec_settings_init(void)
+{
+	uint16_t gen;
+	bool found = false;
+	int ret;
+
+	ret = eeprom_read(SETTINGS_BASE, area, sizeof(area));
+	if (ret) {
+		LOG_ERR("Failed to read settings %d", ret);
+		return ret;
+	}
+
+	k_mutex_lock(&settings_mutex, K_FOREVER);
+
+	for (uint8_t i = 0; i < SECTORS; i++) {
+		if (!sector_valid(&area[i * SECTOR_SIZE], &gen)) {
+			continue;
+		}
+
+		if (!found || (int16_t)(gen - generation) > 0) {
+			found = true;
+			active = i;
+			generation = gen;
+		}
+	}
+
+	if (found) {
+		sector_load(&area[active * SECTOR_SIZE]);
+	} else {
+		/* Blank area, first save compacts into sector 0 */
+		active = SECTORS - 1;
+		generation = 0;
+		write_ofs = SECTOR_SIZE;
+	}
+
+	loaded = true;
+	k_mutex_unlock(&settings_mutex);
+
+	LOG_INF("Settings sector %d gen %d, %d settings", active, generation,
+		cache_count);
+
+	return 0;
+}
+
+int ec_settings_get(uint8_t key, void *data, uint8_t len)
+{
+	struct ec_setting *set;
+	int ret;
+
+	k_mutex_lock(&settings_mutex, K_FOREVER);
+
+	set = cache_find(key);
+	if (!set) {
+		ret = -ENOENT;
+	} else if (set->len > len) {
+		ret = -EINVAL;
+	} else {
+		memcpy(data, set->val, set->len);
+		ret = set->len;
+	}
+
+	k_mutex_unlock(&settings_mutex);
+
+	return ret;
+}
+
+int ec_settings_set(uint8_t key, const void *data, uint8_t len)
+{
+	struct ec_setting *set;
+	struct ec_setting prev = { 0 };
+	uint8_t rec[REC_SIZE(EC_SETTINGS_VAL_MAX)];
+	bool added = false;
+	uint16_t size;
+	int ret = 0;
+
+	if (key == KEY_ERASED || key == KEY_INVALID ||
+	    len > EC_SETTINGS_VAL_MAX) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&settings_mutex, K_FOREVER);
+
+	if (!loaded) {
+		ret = -EIO;
+		goto out;
+	}
+
+	set = cache_find(key);
+	if (set && set->len == len && !memcmp(set->val, data, len)) {
+		goto out;
+	}
+
+	if (!set) {
+		if (cache_count >= MAX_KEYS) {
+			ret = -ENOSPC;
+			goto out;
+		}
+		set = &cache[cache_count++];
+		set->key = key;
+		added = true;
+	} else {
+		prev = *set;
+	}
+
+	set->len = len;
+	memcpy(set->val, data, len);
+
+	size = rec_build(rec, set);
+	if (write_ofs + size > SECTOR_SIZE) {
+		ret = compact();
+	} else {
+		ret = eeprom_write(SECTOR_OFS(active) + write_ofs, rec, size);
+		if (!ret) {
+			write_ofs += size;
+		}
+	}
+
+	if (ret) {
+		LOG_ERR("Failed to save setting %x: %d", key, ret);
+
+		/* Cache must match EEPROM, save is retried on next set */
+		if (added) {
+			cache_count--;
+		} else {
+			*set = prev;
+		}
+	}
+
+out:
+	k_mutex_unlock(&settings_mutex);
+
+	return ret;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief EC persistent settings store.
+ *
+ * Small key-value store kept in EEPROM as an append-only log of records.
+ * All settings are cached in RAM, reads never access the EEPROM.
+ */
+
+#ifndef __EC_SETTINGS_H__
+#define __EC_SETTINGS_H__
+
+#include <zephyr.h>
+
+/* Maximum size of a setting value */
+#define EC_SETTINGS_VAL_MAX	8u
+
+/**
+ * @brief Settings identifiers.
+ *
+ * Identifiers are stored in EEPROM, do NOT reuse values. 0x00 and 0xFF are
+ * reserved.
+ */
+enum ec_settings_key {
+	EC_SETTING_DSW_MODE = 0x01,
+};
+
+/**
+ * @brief Load all settings from EEPROM into RAM.
+ *
+ * Settings area is read in a single transfer.
+ *
+ * @retval 0 if success, error otherwise.
+ */
+int ec_settings_init(void);
+
+/**
+ * @brief Read a setting.
+ *
+ * @param key setting identifier.
+ * @param data buffer where setting value is copied.
+ * @param len size of the buffer.
+ *
+ * @retval setting length if success.
+ * @retval -ENOENT if setting was never saved.
+ * @retval -EINVAL if buffer is smaller than the setting.
+ */
+int ec_settings_get(uint8_t key, void *data, uint8_t len);
+
+/**
+ * @brief Save a setting.
+ *
+ * Nothing is written to EEPROM if value is unchanged. Otherwise a record is
+ * appended to the log, log is compacted into next EEPROM sector once full.
+ *
+ * @param key setting identifier.
+ * @param data setting value.
+ * @param len setting length, up to EC_SETTINGS_VAL_MAX.
+ *
+ * @retval 0 if success, error otherwise.
+ */
+int ec_settings_set(uint8_t key, const void *data, uint8_t len);
+
+#endif /* __EC_SETTINGS_H__ */
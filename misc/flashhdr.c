@@ -4,16 +4,29 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <zephyr.h>
 #include <device.h>
+#include <linker/linker-defs.h>
+#include <sys/crc.h>
+#include <logging/log.h>
+#ifdef CONFIG_ECFW_IMAGE_VERIFY_SHA256
+#include <tinycrypt/constants.h>
+#include <tinycrypt/sha256.h>
+#endif
 #include "board_config.h"
 #include "flashhdr.h"
 
+LOG_MODULE_DECLARE(ecfw, CONFIG_EC_LOG_LEVEL);
+
 #define KSC_MAJOR_VER     1
 #define KSC_MINOR_VER     65
 #define KSC_PATCH_ID      0
 #define KSC_QS_BUILD_VER  0
 
+BUILD_ASSERT(sizeof(struct ksc_img_hdr) == KSC_IMG_HDR_SIZE,
+	     "Image header layout is used by build tools");
+
 __in_section(ecfw_info, static, var) struct ksc_img_hdr header = {
 	/* This is replaced by real checksum in build. */
 	.checksum = 0x0000,
@@ -47,3 +60,114 @@ inline uint8_t qs_build_version(void)
 	return header.version[3];
 }
 
+
+#ifdef CONFIG_ECFW_IMAGE_VERIFY
+static struct k_work verify_work;
+static enum ecfw_image_status image_status;
+/* Image is read in place, header is read from a copy with integrity fields
+ * cleared as they were when computed.
+ */
+static struct ksc_img_hdr header_copy;
+static uint32_t verify_ofs;
+static uint32_t crc;
+#ifdef CONFIG_ECFW_IMAGE_VERIFY_SHA256
+static struct tc_sha256_state_struct sha;
+#endif
+
+static const uint8_t *image_chunk(uint32_t ofs, uint32_t *len)
+{
+	uint32_t hdr_ofs = (uint8_t *)&header - (uint8_t *)_image_rom_start;
+	uint32_t end;
+
+	if (ofs < hdr_ofs) {
+		end = hdr_ofs;
+	} else if (ofs < hdr_ofs + sizeof(header)) {
+		*len = MIN(hdr_ofs + sizeof(header) - ofs,
+			   CONFIG_ECFW_IMAGE_VERIFY_CHUNK);
+		return (uint8_t *)&header_copy + (ofs - hdr_ofs);
+	} else {
+		end = header.img_size;
+	}
+
+	*len = MIN(end - ofs, CONFIG_ECFW_IMAGE_VERIFY_CHUNK);
+
+	return (uint8_t *)_image_rom_start + ofs;
+}
+
+static bool verify_sha256(void)
+{
+#ifdef CONFIG_ECFW_IMAGE_VERIFY_SHA256
+	uint8_t digest[TC_SHA256_DIGEST_SIZE];
+
+	tc_sha256_final(digest, &sha);
+
+	return !memcmp(digest, header.sha256, sizeof(digest));
+#else
+	return true;
+#endif
+}
+
+static void verify_work_handler(struct k_work *work)
+{
+	const uint8_t *data;
+	uint32_t len;
+
+	data = image_chunk(verify_ofs, &len);
+	crc = crc32_ieee_update(crc, data, len);
+#ifdef CONFIG_ECFW_IMAGE_VERIFY_SHA256
+	tc_sha256_update(&sha, data, len);
+#endif
+	verify_ofs += len;
+
+	/* One chunk per work item, other work items run in between */
+	if (verify_ofs < header.img_size) {
+		k_work_submit(&verify_work);
+		return;
+	}
+
+	if (crc == header.crc32 && verify_sha256()) {
+		image_status = ECFW_IMAGE_VALID;
+		LOG_INF("EC FW image valid, crc %08x", crc);
+	} else {
+		image_status = ECFW_IMAGE_CORRUPTED;
+		LOG_ERR("EC FW image corrupted, crc %08x expected %08x", crc,
+			header.crc32);
+	}
+}
+
+void ecfw_image_verify_start(void)
+{
+	uint32_t hdr_ofs = (uint8_t *)&header - (uint8_t *)_image_rom_start;
+
+	if (image_status == ECFW_IMAGE_VERIFYING) {
+		return;
+	}
+
+	/* Image loaded without running build post-processing, e.g. debugger */
+	if (header.img_size < hdr_ofs + sizeof(header)) {
+		LOG_WRN("EC FW image size not set, not verified");
+		image_status = ECFW_IMAGE_UNVERIFIED;
+		return;
+	}
+
+	header_copy = header;
+	header_copy.checksum = 0;
+	header_copy.crc32 = 0;
+	memset(header_copy.sha256, 0, sizeof(header_copy.sha256));
+
+	verify_ofs = 0;
+	crc = 0;
+#ifdef CONFIG_ECFW_IMAGE_VERIFY_SHA256
+	tc_sha256_init(&sha);
+#endif
+
+	image_status = ECFW_IMAGE_VERIFYING;
+	k_work_init(&verify_work, verify_work_handler);
+	k_work_submit(&verify_work);
+}
+
+enum ecfw_image_status ecfw_image_status(void)
+{
+	return image_status;
+}
+#endif /* CONFIG_ECFW_IMAGE_VERIFY */
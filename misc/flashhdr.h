@@ -7,14 +7,31 @@
 #ifndef __FLASH_IMG_HDR_H__
 #define __FLASH_IMG_HDR_H__
 
+#define KSC_IMG_HDR_SIZE	256U
+#define KSC_IMG_SHA256_SIZE	32U
+
+/* checksum, img_size, crc32 and sha256 are filled in by
+ * scripts/ecfw_imghdr.py after build. Integrity fields are computed over
+ * img_size bytes of image with checksum, crc32 and sha256 set to 0.
+ */
 struct ksc_img_hdr {
+	/* Low 16 bits of crc32 */
 	uint16_t checksum;
 	uint8_t signature[4];
 	uint8_t version[4];
 	uint8_t copyright[0x60 - 10];
 	uint32_t img_size;
 	uint8_t platform_str[8];
-	uint16_t platform_id[74];
+	uint16_t platform_id[56];
+	uint32_t crc32;
+	uint8_t sha256[KSC_IMG_SHA256_SIZE];
+};
+
+enum ecfw_image_status {
+	ECFW_IMAGE_UNVERIFIED,
+	ECFW_IMAGE_VERIFYING,
+	ECFW_IMAGE_VALID,
+	ECFW_IMAGE_CORRUPTED,
 };
 
 /**
@@ -45,4 +62,28 @@ uint8_t patch_id(void);
  */
 uint8_t qs_build_version(void);
 
+#ifdef CONFIG_ECFW_IMAGE_VERIFY
+/**
+ * @brief Start EC FW image verification.
+ *
+ * Image is verified in chunks from the system workqueue so boot is not
+ * delayed, result is logged once complete.
+ */
+void ecfw_image_verify_start(void);
+
+/**
+ * @brief Gets EC FW image verification result.
+ *
+ * @retval ECFW_IMAGE_UNVERIFIED if image header was not filled in by build
+ * or verification has not started.
+ */
+enum ecfw_image_status ecfw_image_status(void);
+#else
+static inline void ecfw_image_verify_start(void) {}
+static inline enum ecfw_image_status ecfw_image_status(void)
+{
+	return ECFW_IMAGE_UNVERIFIED;
+}
+#endif
+
 #endif /* __FLASH_IMG_HDR_H__ */
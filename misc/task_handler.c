@@ -16,6 +16,7 @@
 #include "periphmgmt.h"
 #include "kbchost.h"
 #include "task_handler.h"
+#include "pwrseq_notify.h"
 #ifdef CONFIG_THERMAL_MANAGEMENT
 #include "thermalmgmt.h"
 #endif
@@ -31,7 +32,6 @@ LOG_MODULE_DECLARE(pwrmgmt, CONFIG_PWRMGT_LOG_LEVEL);
  */
 #define EC_WAIT_FOREVER (-1)
 
-const uint32_t periph_thrd_period = 1;
 const uint32_t pwrseq_thrd_period = 10;
 const uint32_t smchost_thrd_period = 10;
 
@@ -55,7 +55,7 @@ K_THREAD_DEFINE(postcode_thrd_id, EC_TASK_STACK_SIZE, postcode_thread,
 #endif
 
 K_THREAD_DEFINE(periph_thrd_id, EC_TASK_STACK_SIZE, periph_thread,
-		&periph_thrd_period, NULL, NULL, EC_TASK_PRIORITY,
+		NULL, NULL, NULL, EC_TASK_PRIORITY,
 		K_INHERIT_PERMS, EC_WAIT_FOREVER);
 
 K_THREAD_DEFINE(pwrseq_thrd_id, EC_TASK_STACK_SIZE, pwrseq_thread,
@@ -67,6 +67,14 @@ K_THREAD_DEFINE(oobmngr_thrd_id, OOBMNGR_TASK_STACK_SIZE, oobmngr_thread,
 		NULL, NULL, NULL, EC_TASK_PRIORITY,
 		K_INHERIT_PERMS, EC_WAIT_FOREVER);
 
+#ifdef CONFIG_OOBMNGR_RX_POLL
+/* Never share a thread with power sequencing, polling may block */
+#define OOBPOLL_TASK_STACK_SIZE		512U
+K_THREAD_DEFINE(oobpoll_thrd_id, OOBPOLL_TASK_STACK_SIZE, oobmngr_poll_thread,
+		NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+		K_INHERIT_PERMS, EC_WAIT_FOREVER);
+#endif
+
 K_THREAD_DEFINE(smchost_thrd_id, EC_TASK_STACK_SIZE, smchost_thread,
 		&smchost_thrd_period, NULL, NULL, EC_TASK_PRIORITY,
 		K_INHERIT_PERMS, EC_WAIT_FOREVER);
@@ -112,6 +120,11 @@ static struct task_info tasks[] = {
 	{ .thread_id = oobmngr_thrd_id, .can_suspend = false,
 	  .tagname = "OOB" },
 
+#ifdef CONFIG_OOBMNGR_RX_POLL
+	{ .thread_id = oobpoll_thrd_id, .can_suspend = false,
+	  .tagname = "OOBPOLL" },
+#endif
+
 	{ .thread_id = smchost_thrd_id, .can_suspend = false,
 	  .tagname = "SMC" },
 
@@ -122,8 +135,194 @@ static struct task_info tasks[] = {
 
 };
 
+static sys_slist_t ec_tasks;
+static struct k_spinlock ec_task_lock;
+
+static void ec_task_pstate_change(enum pwrseq_pstate state,
+				  enum pwrseq_pstate prev)
+{
+	struct ec_task *task;
+	uint32_t mask = PWRSEQ_PSTATE_MASK(state) | PWRSEQ_PSTATE_MASK(prev);
+
+	/* Only tasks whose periodic timer gets enabled or disabled */
+	SYS_SLIST_FOR_EACH_CONTAINER(&ec_tasks, task, node) {
+		if (task->period_ms && (task->pstates != EC_TASK_PSTATE_ANY) &&
+		    (task->pstates & mask)) {
+			ec_task_post(task, EC_TASK_WAKE_PSTATE);
+		}
+	}
+}
+
+static struct pwrseq_notifier ec_task_notifier = {
+	.priority = UINT8_MAX,
+	.states = EC_TASK_PSTATE_ANY,
+	.entry = ec_task_pstate_change,
+};
+
+void ec_task_post(struct ec_task *task, uint32_t events)
+{
+	atomic_or(&task->events, events);
+	k_sem_give(&task->wake);
+}
+
+static void ec_task_run_end(struct ec_task *task)
+{
+	uint32_t busy_us;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ec_task_lock);
+	if (!task->registered) {
+		task->registered = true;
+		sys_slist_append(&ec_tasks, &task->node);
+		k_spin_unlock(&ec_task_lock, key);
+		return;
+	}
+	k_spin_unlock(&ec_task_lock, key);
+
+	busy_us = k_cyc_to_us_floor32(k_cycle_get_32() - task->run_start);
+	task->stats.busy_us += busy_us;
+	task->stats.max_busy_us = MAX(task->stats.max_busy_us, busy_us);
+}
+
+static void ec_task_run_start(struct ec_task *task, uint32_t evts)
+{
+	task->stats.wakeups++;
+	if (evts & EC_TASK_WAKE_TIMER) {
+		task->stats.timer_wakeups++;
+	}
+
+	if (evts & EC_TASK_WAKE_PSTATE) {
+		task->stats.pstate_wakeups++;
+	}
+
+	if (evts & EC_TASK_EVT_MASK) {
+		task->stats.event_wakeups++;
+	}
+
+	task->run_start = k_cycle_get_32();
+}
+
+/* Pick a wakeup within [earliest, latest], sharing another task wakeup if
+ * possible, otherwise as late as allowed.
+ */
+static int64_t ec_task_coalesce(struct ec_task *task, int64_t earliest,
+				int64_t latest)
+{
+	struct ec_task *other;
+	int64_t wake = latest;
+
+	task->coalesced = false;
+	SYS_SLIST_FOR_EACH_CONTAINER(&ec_tasks, other, node) {
+		if (other == task || !other->wake_at) {
+			continue;
+		}
+
+		if (other->wake_at >= earliest && other->wake_at <= wake) {
+			wake = other->wake_at;
+			task->coalesced = true;
+		}
+	}
+
+	return wake;
+}
+
+uint32_t ec_task_wait(struct ec_task *task)
+{
+	k_timeout_t timeout = K_FOREVER;
+	k_spinlock_key_t key;
+	int64_t period;
+	int64_t now;
+	uint32_t evts;
+
+	ec_task_run_end(task);
+
+	key = k_spin_lock(&ec_task_lock);
+	period = k_ms_to_ticks_ceil64(task->period_ms);
+	if (period &&
+	    (task->pstates & PWRSEQ_PSTATE_MASK(pwrseq_notify_state()))) {
+		if (!task->deadline) {
+			task->deadline = k_uptime_ticks() + period;
+		}
+
+		task->wake_at = ec_task_coalesce(task, task->deadline,
+				task->deadline +
+				k_ms_to_ticks_floor64(task->slack_ms));
+		timeout = K_TIMEOUT_ABS_TICKS(task->wake_at);
+	} else {
+		/* Timer restarts from scratch once enabled again */
+		task->deadline = 0;
+	}
+	k_spin_unlock(&ec_task_lock, key);
+
+	k_sem_take(&task->wake, timeout);
+	evts = atomic_clear(&task->events);
+
+	key = k_spin_lock(&ec_task_lock);
+	now = k_uptime_ticks();
+	if (task->wake_at && now >= task->wake_at) {
+		evts |= EC_TASK_WAKE_TIMER;
+		if (task->coalesced) {
+			task->stats.coalesced++;
+		}
+
+		/* Keep nominal schedule, skip missed periods */
+		do {
+			task->deadline += period;
+		} while (task->deadline <= now);
+	}
+	task->wake_at = 0;
+	k_spin_unlock(&ec_task_lock, key);
+
+	ec_task_run_start(task, evts);
+
+	return evts;
+}
+
+uint32_t ec_task_wait_timeout(struct ec_task *task, k_timeout_t timeout)
+{
+	uint32_t evts;
+
+	ec_task_run_end(task);
+
+	k_sem_take(&task->wake, timeout);
+	evts = atomic_clear(&task->events);
+
+	ec_task_run_start(task, evts ? evts : EC_TASK_WAKE_TIMER);
+
+	return evts;
+}
+
+void ec_task_set_period(struct ec_task *task, uint32_t period_ms)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ec_task_lock);
+	if (task->period_ms != period_ms) {
+		task->period_ms = period_ms;
+		task->deadline = 0;
+	}
+	k_spin_unlock(&ec_task_lock, key);
+}
+
+void ec_task_report(void)
+{
+	struct ec_task *task;
+	struct ec_task_stats *st;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ec_tasks, task, node) {
+		st = &task->stats;
+		LOG_INF("%s wakeups %d timer %d (coalesced %d) evt %d pstate %d",
+			task->name, st->wakeups, st->timer_wakeups,
+			st->coalesced, st->event_wakeups, st->pstate_wakeups);
+		LOG_INF("%s busy %d ms max %d us", task->name,
+			(uint32_t)(st->busy_us / 1000U), st->max_busy_us);
+	}
+}
+
 void start_all_tasks(void)
 {
+	pwrseq_notify_register(&ec_task_notifier);
+
 	for (int i = 0; i < ARRAY_SIZE(tasks); i++) {
 		if (tasks[i].thread_id) {
 #ifdef CONFIG_THREAD_NAME
@@ -7,10 +7,83 @@
 #ifndef __TASK_HANDLER_H__
 #define __TASK_HANDLER_H__
 
+#include <zephyr.h>
+#include <sys/slist.h>
+
 #define EC_TASK_PRIORITY	K_PRIO_COOP(5)
 
 #define THRML_MGMT_TASK_NAME    "THRMLMGMT"
 
+/* Wake reasons returned by ec_task_wait(), along with posted event bits */
+#define EC_TASK_WAKE_TIMER	BIT(31)
+#define EC_TASK_WAKE_PSTATE	BIT(30)
+#define EC_TASK_EVT_MASK	GENMASK(29, 0)
+
+/* Periodic timer active regardless of platform power state */
+#define EC_TASK_PSTATE_ANY	UINT32_MAX
+
+/**
+ * @brief Per task wakeup accounting.
+ */
+struct ec_task_stats {
+	uint32_t wakeups;
+	uint32_t timer_wakeups;
+	uint32_t event_wakeups;
+	uint32_t pstate_wakeups;
+	/* Timer wakeups aligned with another task wakeup */
+	uint32_t coalesced;
+	/* Time spent running between waits */
+	uint64_t busy_us;
+	uint32_t max_busy_us;
+};
+
+/**
+ * @brief EC task wake sources.
+ *
+ * A task is only scheduled when one of its wake sources fires: an event
+ * posted with ec_task_post(), its periodic timer or a platform power state
+ * change relevant to its periodic timer.
+ *
+ * Periodic timer wakeups may be delayed by up to slack_ms to share a
+ * wakeup with another task, letting the SoC stay longer in deep sleep.
+ * Timer keeps its nominal schedule, delays do not accumulate.
+ */
+struct ec_task {
+	sys_snode_t node;
+	const char *name;
+	struct k_sem wake;
+	atomic_t events;
+	uint32_t period_ms;
+	uint32_t slack_ms;
+	/* PWRSEQ_PSTATE_MASK() of states in which periodic timer runs */
+	uint32_t pstates;
+	/* Nominal timer deadline and programmed wakeup, in ticks */
+	int64_t deadline;
+	int64_t wake_at;
+	bool coalesced;
+	bool registered;
+	uint32_t run_start;
+	struct ec_task_stats stats;
+};
+
+/**
+ * @brief Statically define an EC task wake context.
+ *
+ * @param _obj variable name.
+ * @param _name task name used in reports.
+ * @param _period_ms periodic timer, 0 if none.
+ * @param _slack_ms maximum timer delay allowed for wakeup coalescing.
+ * @param _pstates power states in which periodic timer is active.
+ */
+#define EC_TASK_DEFINE(_obj, _name, _period_ms, _slack_ms, _pstates)	\
+	struct ec_task _obj = {						\
+		.name = (_name),					\
+		.wake = Z_SEM_INITIALIZER(_obj.wake, 0, 1),		\
+		.period_ms = (_period_ms),				\
+		.slack_ms = (_slack_ms),				\
+		.pstates = (_pstates),					\
+	}
+
 /**
  * @brief Set names for all tasks in the app.
  *
@@ -35,4 +108,52 @@ void resume_all_tasks(void);
  */
 void wake_task(const char *tagname);
 
+/**
+ * @brief Post events to a task.
+ *
+ * @param task task to wake up.
+ * @param events task specific event bits within EC_TASK_EVT_MASK.
+ *
+ * @note Can be called from ISR.
+ */
+void ec_task_post(struct ec_task *task, uint32_t events);
+
+/**
+ * @brief Wait for any wake source of the task.
+ *
+ * @param task calling task.
+ *
+ * @retval events posted since previous wait, along with EC_TASK_WAKE_TIMER
+ * if periodic timer expired and EC_TASK_WAKE_PSTATE on power state change.
+ */
+uint32_t ec_task_wait(struct ec_task *task);
+
+/**
+ * @brief Wait for task events with an explicit timeout.
+ *
+ * Meant for waits within a sequence where timing matters, timeout is
+ * never coalesced.
+ *
+ * @param task calling task.
+ * @param timeout maximum time to wait.
+ *
+ * @retval events posted since previous wait, 0 on timeout.
+ */
+uint32_t ec_task_wait_timeout(struct ec_task *task, k_timeout_t timeout);
+
+/**
+ * @brief Change task periodic timer.
+ *
+ * Next deadline is one period from now, no change if period is the same.
+ *
+ * @param task task to update.
+ * @param period_ms new period, 0 to disable periodic timer.
+ */
+void ec_task_set_period(struct ec_task *task, uint32_t period_ms);
+
+/**
+ * @brief Log wakeup accounting of all tasks.
+ */
+void ec_task_report(void);
+
 #endif /* __TASK_HANDLER_H__ */
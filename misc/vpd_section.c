@@ -68,11 +68,10 @@ union emi_eeprom_vpd {
 
 static int _write_vpd(const uint8_t *data, uint16_t offset, uint16_t length)
 {
-	for (uint16_t i = 0; i < length; i++) {
-		if (eeprom_write_byte(EEPROM_VPD_OFFSET + offset + i, data[offset + i])) {
-			LOG_ERR("Could not write byte %u", offset + i);
-			return -1;
-		}
+	if (eeprom_write(EEPROM_VPD_OFFSET + offset, &data[offset], length)) {
+		LOG_ERR("Could not write bytes %u-%u", offset,
+			offset + length - 1);
+		return -1;
 	}
 	return 0;
 }
@@ -85,23 +84,19 @@ static int _write_vpd(const uint8_t *data, uint16_t offset, uint16_t length)
 void expose_vpd_section(void)
 {
 	static __attribute__((aligned(4))) union emi_eeprom_vpd vpd_shadow = { 0 };
-
-	const uint16_t vpd_shadow_aligned_size = ROUND_UP(sizeof(vpd_shadow), sizeof(uint32_t));
-
-	emi_t emi;
-	emi_get(&emi, EMI_INSTANCE_0);
+	static emi_block_t vpd_blk;
 
 	/*
-	 * Ensure EMI region base and size are aligned to a DWORD
-	 * boundary, as the registers only have DWORD granularity.
+	 * VPD keeps the whole EMI region 0 for hosts reading it directly.
+	 * Until EEPROM is read, magic is invalid and block generation is 0.
 	 */
-	emi_region_config_t rconf = {
-		.base        = (uint32_t)(uintptr_t)&vpd_shadow,
-		.read_limit  = vpd_shadow_aligned_size,
-		.write_limit = 0
-	};
+	bool exposed = emi_block_publish_region(&vpd_blk, EMI_BLOCK_VPD,
+						VPD_LATEST_REVISION,
+						EMI_REGION_0, &vpd_shadow,
+						sizeof(vpd_shadow)) == EMI_SUCCESS;
 
-	emi_configure_region(&emi, EMI_REGION_0, &rconf);
+	if (!exposed)
+		LOG_ERR("Could not expose VPD");
 
 #if defined(CONFIG_VPD_PROGRAM_EEPROM) && CONFIG_VPD_PROGRAM_EEPROM == 1
 
@@ -119,34 +114,41 @@ void expose_vpd_section(void)
 #if defined(CONFIG_VPD_PROGRAM_EVERYTHING) && CONFIG_VPD_PROGRAM_EVERYTHING == 1
 
 	if (write_vpd(prog_vpd, raw))
-		return;
+		goto out;
 
 #else
 
 	if (CONFIG_VPD_SERIAL_NUMBER[0] != '\0')
 		if (write_vpd(prog_vpd, serial_number))
-			return;
+			goto out;
 
 	if (CONFIG_VPD_PART_NUMBER[0] != '\0')
 		if (write_vpd(prog_vpd, part_number))
-			return;
+			goto out;
 
 	if (CONFIG_VPD_PROFILE != 0)
 		if (write_vpd(prog_vpd, profile))
-			return;
+			goto out;
 
 #endif	/* VPD_PROGRAM_EVERYTHING */
 
 #endif	/* VPD_PROGRAM_EEPROM */
 
-	for (uint16_t i = 0; i < sizeof(vpd_shadow); i++) {
-		if (eeprom_read_byte(EEPROM_VPD_OFFSET + i, &vpd_shadow.raw[i])) {
-			LOG_ERR("Could not read byte %u", i);
-			/* Invalidate the magic */
-			vpd_shadow.header.magic = 0;
-			return;
-		}
+	if (exposed)
+		emi_block_update_begin(&vpd_blk);
+
+	if (eeprom_read(EEPROM_VPD_OFFSET, vpd_shadow.raw, sizeof(vpd_shadow))) {
+		LOG_ERR("Could not read VPD");
+		/* Invalidate the magic */
+		vpd_shadow.header.magic = 0;
+	} else {
+		LOG_HEXDUMP_DBG(vpd_shadow.raw, sizeof(vpd_shadow.raw), "New VPD:");
 	}
 
-	LOG_HEXDUMP_DBG(vpd_shadow.raw, sizeof(vpd_shadow.raw), "New VPD:");
+#if defined(CONFIG_VPD_PROGRAM_EEPROM) && CONFIG_VPD_PROGRAM_EEPROM == 1
+out:
+#endif
+	/* Host checks the magic to tell a failed read from valid VPD */
+	if (exposed)
+		emi_block_update_end(&vpd_blk);
 }
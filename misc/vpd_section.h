@@ -7,6 +7,12 @@
 #ifndef VPD_SECTION_H
 #define VPD_SECTION_H
 
+/**
+ * @brief Expose VPD to the host over EMI and populate it from EEPROM.
+ *
+ * EMI block generation stays 0 until EEPROM is read, so it can be called
+ * after tasks are started.
+ */
 void expose_vpd_section(void);
 
 #endif
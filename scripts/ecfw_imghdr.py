@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Fill in EC FW image header integrity fields.
+
+Locates struct ksc_img_hdr (misc/flashhdr.h) in the raw EC FW binary and
+writes image size, CRC32, SHA-256 and the legacy 16-bit checksum. Integrity
+fields are computed over the whole image with checksum, crc32 and sha256
+set to 0, as EC FW does when verifying the image.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+import zlib
+
+HDR_SIZE = 256
+SIGNATURE = b'TKSC'
+SIGNATURE_OFS = 2
+COPYRIGHT_OFS = 10
+CHECKSUM_OFS = 0
+IMG_SIZE_OFS = 96
+CRC32_OFS = 220
+SHA256_OFS = 224
+SHA256_SIZE = 32
+
+
+def find_header(img):
+    ofs = []
+    pos = img.find(SIGNATURE)
+    while pos >= 0:
+        hdr = pos - SIGNATURE_OFS
+        if (hdr >= 0 and hdr + HDR_SIZE <= len(img) and
+                img[hdr + COPYRIGHT_OFS:].startswith(b'Copyright')):
+            ofs.append(hdr)
+        pos = img.find(SIGNATURE, pos + 1)
+
+    if len(ofs) != 1:
+        sys.exit('error: found %d image headers' % len(ofs))
+
+    return ofs[0]
+
+
+def patch(img):
+    hdr = find_header(img)
+
+    struct.pack_into('<H', img, hdr + CHECKSUM_OFS, 0)
+    struct.pack_into('<I', img, hdr + IMG_SIZE_OFS, len(img))
+    struct.pack_into('<I', img, hdr + CRC32_OFS, 0)
+    img[hdr + SHA256_OFS:hdr + SHA256_OFS + SHA256_SIZE] = bytes(SHA256_SIZE)
+
+    crc = zlib.crc32(img) & 0xFFFFFFFF
+    sha = hashlib.sha256(img).digest()
+
+    struct.pack_into('<H', img, hdr + CHECKSUM_OFS, crc & 0xFFFF)
+    struct.pack_into('<I', img, hdr + CRC32_OFS, crc)
+    img[hdr + SHA256_OFS:hdr + SHA256_OFS + SHA256_SIZE] = sha
+
+    return hdr, crc, sha
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('image', help='EC FW raw binary, patched in place')
+    parser.add_argument('-q', '--quiet', action='store_true')
+    args = parser.parse_args()
+
+    with open(args.image, 'rb') as f:
+        img = bytearray(f.read())
+
+    hdr, crc, sha = patch(img)
+
+    with open(args.image, 'wb') as f:
+        f.write(img)
+
+    if not args.quiet:
+        print('ecfw image header at 0x%x: size %d crc32 %08x sha256 %s' %
+              (hdr, len(img), crc, sha.hex()))
+
+
+if __name__ == '__main__':
+    main()
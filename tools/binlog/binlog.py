@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Read and decode EC binary log.
+
+EC FW keeps log messages in Zephyr dictionary format in a RAM ring
+(CONFIG_BINLOG). The log can be read from the EC through the ACPI EC
+interface (requires root access to /dev/port), from a dump of EC EMI region
+1, where the ring is found through the EMI block directory, or from a
+console capture holding a "binlog:" dump.
+
+Messages are decoded by Zephyr dictionary log parser with the log database
+of the same EC FW build, either log_dictionary.json from the build folder
+or generated from the EC FW ELF.
+"""
+
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "common"))
+from ec_host import EMI_BLOCK_LOG, EcPort, emi_block  # noqa: E402
+
+SMCHOST_GET_BINARY_LOG = 0x5E
+CHUNK_SIZE = 8
+
+BINLOG_MAGIC = 0x4C42
+BINLOG_VERSION = 1
+HDR_FMT = "<HBxHxxII"
+HDR_SIZE = struct.calcsize(HDR_FMT)
+REC_HDR_SIZE = 2
+
+UART_PREFIX = "binlog:"
+
+DICT_DIR = os.path.join("scripts", "logging", "dictionary")
+
+
+def parse_hdr(data):
+    magic, version, size, head, tail = struct.unpack_from(HDR_FMT, data)
+    if magic != BINLOG_MAGIC or version != BINLOG_VERSION:
+        raise ValueError("No binary log available")
+
+    return size, head, tail
+
+
+def read_log():
+    """Read log stream over SMC, return stream and tail once read."""
+    ec = EcPort()
+
+    def chunk(idx):
+        return ec.command(SMCHOST_GET_BINARY_LOG,
+                          [idx & 0xFF, idx >> 8], CHUNK_SIZE)
+
+    stream = bytearray(chunk(0))
+    stream += chunk(1)
+    _, head, tail = parse_hdr(stream)
+
+    length = HDR_SIZE + ((head - tail) & 0xFFFFFFFF)
+    for idx in range(2, (length + CHUNK_SIZE - 1) // CHUNK_SIZE):
+        stream += chunk(idx)
+
+    # Oldest records may have been overwritten while reading
+    _, _, new_tail = parse_hdr(chunk(0) + chunk(1))
+
+    return bytes(stream[:length]), new_tail
+
+
+def ring_to_stream(ring):
+    """Linearize ring data from tail to head, as read over SMC."""
+    size, head, tail = parse_hdr(ring)
+    data = ring[HDR_SIZE:HDR_SIZE + size]
+    used = (head - tail) & 0xFFFFFFFF
+
+    return ring[:HDR_SIZE] + bytes(data[(tail + i) % size]
+                                   for i in range(used))
+
+
+def uart_to_stream(text):
+    """Return last complete dump found in a console capture."""
+    stream = bytearray()
+    last = None
+    length = None
+
+    for line in text.splitlines():
+        idx = line.find(UART_PREFIX)
+        if idx < 0:
+            continue
+
+        match = re.match(r"[0-9a-fA-F]*", line[idx + len(UART_PREFIX):])
+        stream += bytes.fromhex(match.group(0))
+        if length is None and len(stream) >= HDR_SIZE:
+            _, head, tail = parse_hdr(stream)
+            length = HDR_SIZE + ((head - tail) & 0xFFFFFFFF)
+
+        if length is not None and len(stream) >= length:
+            last = bytes(stream[:length])
+            stream = bytearray()
+            length = None
+
+    if last is None:
+        raise ValueError("No binary log dump in console capture")
+
+    return last
+
+
+def records(stream, new_tail=None):
+    """Return log messages in stream, oldest first.
+
+    Records before new_tail were overwritten while reading and are skipped.
+    """
+    _, head, tail = parse_hdr(stream)
+    data = stream[HDR_SIZE:]
+    used = (head - tail) & 0xFFFFFFFF
+
+    ofs = 0
+    if new_tail is not None:
+        skip = (new_tail - tail) & 0xFFFFFFFF
+        if skip > used:
+            raise ValueError("Log overwritten while reading, retry")
+        ofs = skip
+
+    msgs = []
+    while ofs + REC_HDR_SIZE <= used:
+        length = struct.unpack_from("<H", data, ofs)[0]
+        ofs += REC_HDR_SIZE
+        if ofs + length > used:
+            break
+        msgs.append(data[ofs:ofs + length])
+        ofs += length
+
+    return msgs
+
+
+def zephyr_script(name):
+    base = os.environ.get("ZEPHYR_BASE")
+    if not base:
+        raise ValueError("ZEPHYR_BASE not set")
+
+    return os.path.join(base, DICT_DIR, name)
+
+
+def decode(msgs, db, elf):
+    with tempfile.TemporaryDirectory() as tmp:
+        if elf:
+            db = os.path.join(tmp, "log_dictionary.json")
+            subprocess.run([sys.executable, zephyr_script("database_gen.py"),
+                            "--json", db, elf], check=True)
+
+        logfile = os.path.join(tmp, "binlog.bin")
+        with open(logfile, "wb") as f:
+            f.write(b"".join(msgs))
+
+        return subprocess.run([sys.executable, zephyr_script("log_parser.py"),
+                               db, logfile]).returncode
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    src = parser.add_mutually_exclusive_group()
+    src.add_argument("-i", "--input",
+                     help="decode a raw log or EMI region 1 dump")
+    src.add_argument("-u", "--uart", help="decode a console capture")
+    parser.add_argument("-o", "--output", help="save raw log to file")
+    parser.add_argument("-d", "--database",
+                        default=os.path.join("build", "zephyr",
+                                             "log_dictionary.json"),
+                        help="log database of the EC FW build")
+    parser.add_argument("-e", "--elf",
+                        help="EC FW ELF, log database is generated from it")
+    args = parser.parse_args()
+
+    new_tail = None
+    if args.input:
+        with open(args.input, "rb") as f:
+            data = f.read()
+        ring = emi_block(data, EMI_BLOCK_LOG, "binary log")
+        stream = ring_to_stream(ring) if ring else data
+    elif args.uart:
+        with open(args.uart, errors="replace") as f:
+            stream = uart_to_stream(f.read())
+    else:
+        stream, new_tail = read_log()
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(stream)
+
+    msgs = records(stream, new_tail)
+    print("%d messages" % len(msgs), file=sys.stderr)
+
+    return decode(msgs, args.database, args.elf)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#
+# Copyright (c) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""EC host access shared by EC FW debug tools.
+
+EcPort sends SMC host commands through the ACPI EC interface (requires root
+access to /dev/port). emi_block() finds a block in a dump of EC EMI region 1
+through the EMI block directory at the start of the region.
+"""
+
+import os
+import struct
+import time
+
+EC_DATA_PORT = 0x62
+EC_CMD_PORT = 0x66
+EC_STS_OBF = 0x01
+EC_STS_IBF = 0x02
+
+EMI_DIR_MAGIC = 0x52494D45
+EMI_DIR_FMT = "<IBBH"
+EMI_DESC_FMT = "<BBBxHHI"
+
+# EMI_BLOCK_TYPE in drivers/emi.h
+EMI_BLOCK_PWRSEQ_TRACE = 2
+EMI_BLOCK_LOG = 3
+
+
+class EcPort:
+    """Minimal ACPI EC command interface over /dev/port."""
+
+    def __init__(self):
+        self.fd = os.open("/dev/port", os.O_RDWR)
+
+    def _inb(self, port):
+        os.lseek(self.fd, port, os.SEEK_SET)
+        return os.read(self.fd, 1)[0]
+
+    def _outb(self, port, val):
+        os.lseek(self.fd, port, os.SEEK_SET)
+        os.write(self.fd, bytes([val]))
+
+    def _wait(self, mask, value, timeout=1.0):
+        end = time.monotonic() + timeout
+        while (self._inb(EC_CMD_PORT) & mask) != value:
+            if time.monotonic() > end:
+                raise TimeoutError("EC not responding")
+            time.sleep(0.0005)
+
+    def command(self, cmd, params, resp_len):
+        self._wait(EC_STS_IBF, 0)
+        self._outb(EC_CMD_PORT, cmd)
+        for param in params:
+            self._wait(EC_STS_IBF, 0)
+            self._outb(EC_DATA_PORT, param)
+
+        resp = bytearray()
+        for _ in range(resp_len):
+            self._wait(EC_STS_OBF, EC_STS_OBF)
+            resp.append(self._inb(EC_DATA_PORT))
+
+        return bytes(resp)
+
+
+def emi_block(data, block_type, name):
+    """Return block data from an EMI region 1 dump, None if not a dump."""
+    if len(data) < struct.calcsize(EMI_DIR_FMT):
+        return None
+
+    magic, _, count, _ = struct.unpack_from(EMI_DIR_FMT, data)
+    if magic != EMI_DIR_MAGIC:
+        return None
+
+    ofs = struct.calcsize(EMI_DIR_FMT)
+    for _ in range(count):
+        btype, _, _, bofs, size, gen = struct.unpack_from(EMI_DESC_FMT, data,
+                                                          ofs)
+        if btype == block_type:
+            if gen == 0 or gen & 1:
+                raise ValueError("%s not ready, retry" % name)
+            return data[bofs:bofs + size]
+        ofs += struct.calcsize(EMI_DESC_FMT)
+
+    raise ValueError("No %s in EMI dump" % name)
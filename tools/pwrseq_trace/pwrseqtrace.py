@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Read and decode EC power sequence timing trace.
+
+The trace can be read from the EC through the ACPI EC interface (requires
+root access to /dev/port) or decoded from a raw dump, either previously saved
+with -o or read from the EC EMI region 1, where the trace is found through
+the EMI block directory.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "common"))
+from ec_host import EMI_BLOCK_PWRSEQ_TRACE, EcPort, emi_block  # noqa: E402
+
+SMCHOST_GET_PWRSEQ_TRACE = 0x5C
+CHUNK_SIZE = 8
+
+TRACE_MAGIC = 0x5350
+TRACE_VERSION = 1
+HDR_FMT = "<HBBBBxx"
+SEQ_FMT = "<BBBBII"
+STEP_FMT = "<BBBBII"
+
+SEQ_TYPES = {
+    1: "INIT",
+    2: "BOOT",
+    3: "RESUME",
+    4: "SUSPEND",
+    5: "SHUTDOWN",
+}
+
+SRC_GPIO = 0
+SRC_VWIRE = 1
+SRC_ESPI_RST = 2
+SRC_VWIRE_LOW = 3
+SRC_VWIRE_HIGH = 4
+
+PINS = {
+    0: "GPIO",
+    1: "RSMRST_PWRGD",
+    2: "ESPI_RESET",
+    3: "ALL_SYS_PWRGD",
+    4: "PWR_OK",
+    5: "PWRBTN",
+    6: "SLP_SUS",
+}
+
+# enum espi_vwire_signal
+VWIRES = [
+    "SLP_S3", "SLP_S4", "SLP_S5", "OOB_RST_WARN", "PLTRST", "SUS_STAT",
+    "NMIOUT", "SMIOUT", "HOST_RST_WARN", "SLP_A", "SUS_PWRDN_ACK",
+    "SUS_WARN", "SLP_WLAN", "SLP_LAN", "HOST_C10", "DNX_WARN",
+]
+
+STATUS = {
+    0: "ok",
+    5: "EIO",
+    22: "EINVAL",
+    116: "TIMEOUT",
+}
+
+BAR_WIDTH = 40
+
+
+def log_size(seq_count, step_count):
+    seq_size = struct.calcsize(SEQ_FMT) + step_count * \
+        struct.calcsize(STEP_FMT)
+    return struct.calcsize(HDR_FMT) + seq_count * seq_size
+
+
+def read_trace():
+    ec = EcPort()
+
+    def chunk(idx):
+        return ec.command(SMCHOST_GET_PWRSEQ_TRACE,
+                          [idx & 0xFF, idx >> 8], CHUNK_SIZE)
+
+    data = bytearray(chunk(0))
+    magic, _, seq_count, step_count, _ = struct.unpack_from(HDR_FMT, data)
+    if magic != TRACE_MAGIC:
+        raise ValueError("No power sequence trace available")
+
+    size = log_size(seq_count, step_count)
+    for idx in range(1, (size + CHUNK_SIZE - 1) // CHUNK_SIZE):
+        data += chunk(idx)
+
+    return bytes(data[:size])
+
+
+def vwire_name(sig):
+    return VWIRES[sig] if sig < len(VWIRES) else str(sig)
+
+
+def step_name(src, sig, gpio):
+    if src == SRC_GPIO:
+        name = PINS.get(sig, "PIN_%d" % sig)
+        return "%s (GPIO%03o)" % (name, gpio)
+    if src == SRC_VWIRE:
+        return "VW " + vwire_name(sig)
+    if src in (SRC_VWIRE_LOW, SRC_VWIRE_HIGH):
+        return "host VW %s=%d" % (vwire_name(sig), src == SRC_VWIRE_HIGH)
+    if src == SRC_ESPI_RST:
+        return "ESPI_RST=%d" % sig
+    return "SRC_%d_%d" % (src, sig)
+
+
+def print_seq(seq, steps):
+    stype, count, num, error, start_ms, dur_us = seq
+    total = dur_us if dur_us else max(
+        [s[4] + s[5] for s in steps] + [1])
+
+    print("#%-3d %-8s at %d ms, %s%s" %
+          (num, SEQ_TYPES.get(stype, str(stype)), start_ms,
+           "%.3f ms" % (dur_us / 1000.0) if dur_us else "in progress",
+           ", error %d" % error if error else ""))
+
+    for src, sig, gpio, status, start_us, step_us in steps:
+        ofs = BAR_WIDTH * start_us // total
+        width = max(1, BAR_WIDTH * step_us // total)
+        bar = " " * ofs + "#" * min(width, BAR_WIDTH - ofs)
+        print("  %-28s %9.3f %9.3f  %-7s |%-*s|" %
+              (step_name(src, sig, gpio), start_us / 1000.0,
+               step_us / 1000.0, STATUS.get(status, "E%d" % status),
+               BAR_WIDTH, bar))
+    print()
+
+
+def decode(data):
+    (magic, version, seq_count, step_count,
+     last) = struct.unpack_from(HDR_FMT, data)
+    if magic != TRACE_MAGIC or version != TRACE_VERSION:
+        raise ValueError("Invalid power sequence trace header")
+
+    step_size = struct.calcsize(STEP_FMT)
+    seq_size = struct.calcsize(SEQ_FMT) + step_count * step_size
+
+    print("  %-28s %9s %9s  %-7s" % ("step", "start_ms", "dur_ms", "status"))
+
+    # Oldest sequence first
+    for i in range(1, seq_count + 1):
+        ofs = struct.calcsize(HDR_FMT) + ((last + i) % seq_count) * seq_size
+        seq = struct.unpack_from(SEQ_FMT, data, ofs)
+        if seq[0] == 0:
+            continue
+
+        ofs += struct.calcsize(SEQ_FMT)
+        steps = [struct.unpack_from(STEP_FMT, data, ofs + n * step_size)
+                 for n in range(min(seq[1], step_count))]
+        print_seq(seq, steps)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("-i", "--input", help="decode a raw trace file")
+    parser.add_argument("-o", "--output", help="save raw trace to file")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, "rb") as f:
+            data = f.read()
+        data = emi_block(data, EMI_BLOCK_PWRSEQ_TRACE,
+                         "power sequence trace") or data
+    else:
+        data = read_trace()
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(data)
+
+    decode(data)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
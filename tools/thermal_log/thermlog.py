@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Read and decode EC thermal telemetry log.
+
+The log can be read from the EC through the ACPI EC interface (requires root
+access to /dev/port) or decoded from a raw dump previously saved with -o.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "..", "common"))
+from ec_host import EcPort  # noqa: E402
+
+SMCHOST_GET_THERMAL_LOG = 0x5B
+CHUNK_SIZE = 8
+
+LOG_MAGIC = 0x4C54
+LOG_VERSION = 1
+HDR_SIZE = 8
+BLK_HDR_SIZE = 2
+
+REC_TYPE_MASK = 0xC0
+REC_DATA_MASK = 0x3F
+REC_DELTA = 0x00
+REC_KEYFRAME = 0x40
+REC_EVENT = 0x80
+REC_IDLE = 0xC0
+
+RPM_DELTA_UNIT = 16
+
+FIELDS = ["cpu", "gpu", "pch", "duty", "rpm", "flags"]
+
+FLAGS = {
+    0x01: "FAN_OVR",
+    0x02: "HOST_FAN",
+    0x04: "BSOD_OVR",
+    0x08: "PROCHOT",
+}
+
+EVENTS = {
+    1: "THERMAL_SHUTDOWN",
+    2: "CPU_TEMP_FAIL",
+    3: "GPU_TEMP_FAIL",
+    4: "PROCHOT_ASSERT",
+    5: "PROCHOT_DEASSERT",
+    6: "CRIT_TEMP_UPDATE",
+}
+
+SOURCES = {"live": 0, "shutdown": 1}
+
+
+def read_log(source):
+    ec = EcPort()
+    src = SOURCES[source]
+
+    def chunk(idx):
+        return ec.command(SMCHOST_GET_THERMAL_LOG,
+                          [src, idx & 0xFF, idx >> 8], CHUNK_SIZE)
+
+    data = bytearray(chunk(0))
+    magic, version, blk_size, blk_count = struct.unpack_from("<HBBB", data)
+    if magic != LOG_MAGIC:
+        raise ValueError("No thermal log available")
+
+    size = HDR_SIZE + blk_size * blk_count
+    for idx in range(1, (size + CHUNK_SIZE - 1) // CHUNK_SIZE):
+        data += chunk(idx)
+
+    return bytes(data[:size])
+
+
+def fmt_flags(flags):
+    names = [name for bit, name in FLAGS.items() if flags & bit]
+    return "|".join(names) if names else "-"
+
+
+def decode_block(blk, period_ms, out):
+    used = blk[1]
+    if used < BLK_HDR_SIZE or used > len(blk):
+        raise ValueError("corrupted block")
+
+    state = None
+    now = 0
+    pos = BLK_HDR_SIZE
+
+    def emit():
+        out.append((now, dict(state)))
+
+    while pos < used:
+        hdr = blk[pos]
+        pos += 1
+        rtype = hdr & REC_TYPE_MASK
+
+        if rtype == REC_KEYFRAME:
+            (now, cpu, gpu, pch, duty, rpm,
+             flags) = struct.unpack_from("<IBBBBHB", blk, pos)
+            pos += 11
+            state = {"cpu": cpu, "gpu": gpu, "pch": pch, "duty": duty,
+                     "rpm": rpm, "flags": flags}
+            emit()
+        elif state is None:
+            raise ValueError("block does not start with a keyframe")
+        elif rtype == REC_DELTA:
+            now += period_ms
+            for idx, field in enumerate(FIELDS):
+                if hdr & (1 << idx):
+                    (delta,) = struct.unpack_from("b", blk, pos)
+                    pos += 1
+                    if field == "rpm":
+                        delta *= RPM_DELTA_UNIT
+                    state[field] = (state[field] + delta) & \
+                        (0xFFFF if field == "rpm" else 0xFF)
+            emit()
+        elif rtype == REC_IDLE:
+            for _ in range(hdr & REC_DATA_MASK):
+                now += period_ms
+                emit()
+        else:
+            code = hdr & REC_DATA_MASK
+            out.append((now, EVENTS.get(code, "EVENT_%d" % code)))
+
+
+def decode(data, period_ms):
+    magic, version, blk_size, blk_count = struct.unpack_from("<HBBB", data)
+    if magic != LOG_MAGIC or version != LOG_VERSION:
+        raise ValueError("Invalid thermal log header")
+
+    print("%10s %5s %5s %5s %5s %6s  %s" %
+          ("time_ms", "cpu", "gpu", "pch", "duty", "rpm", "flags"))
+
+    prev_seq = None
+    for blk_idx in range(blk_count):
+        ofs = HDR_SIZE + blk_idx * blk_size
+        blk = data[ofs:ofs + blk_size]
+        seq = blk[0]
+
+        if prev_seq is not None and seq != (prev_seq + 1) & 0xFF:
+            print("--- %d block(s) lost ---" % ((seq - prev_seq - 1) & 0xFF))
+        prev_seq = seq
+
+        entries = []
+        try:
+            decode_block(blk, period_ms, entries)
+        except (ValueError, struct.error) as err:
+            print("--- block %d: %s ---" % (seq, err))
+            continue
+
+        for now, entry in entries:
+            if isinstance(entry, str):
+                print("%10d  ** %s **" % (now, entry))
+            else:
+                print("%10d %5d %5d %5d %5d %6d  %s" %
+                      (now, entry["cpu"], entry["gpu"], entry["pch"],
+                       entry["duty"], entry["rpm"],
+                       fmt_flags(entry["flags"])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("-s", "--source", choices=SOURCES.keys(),
+                        default="live", help="log to read from the EC")
+    parser.add_argument("-i", "--input", help="decode a raw log file")
+    parser.add_argument("-o", "--output", help="save raw log to file")
+    parser.add_argument("-p", "--period-ms", type=int, default=1000,
+                        help="sampling period configured in EC FW")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, "rb") as f:
+            data = f.read()
+    else:
+        data = read_log(args.source)
+
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(data)
+
+    decode(data, args.period_ms)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())